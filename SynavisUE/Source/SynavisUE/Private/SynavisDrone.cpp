@@ -131,6 +131,289 @@ void ASynavisDrone::AppendToMesh(TSharedPtr<FJsonObject> Jason)
   procmesh->CreateMeshSection(section, Points, Triangles, Normals, UVs, {}, Tangents, false);
 }
 
+// mirror of Synavis::BinaryGeometryHeader (synavis/DataConnector.hpp)
+#pragma pack(push, 1)
+struct FBinaryGeometryHeader
+{
+  uint32 Magic;
+  ANSICHAR Name[16];
+  uint8 ElementType; // 0 float32, 1 float64, 2 int32, 3 uint32
+  uint8 Reserved;
+  uint16 TransferId; // echoed as player_id, 0 if the frame belongs to no transfer
+  uint32 Count;
+  uint64 Offset;
+  uint64 Total;
+};
+#pragma pack(pop)
+static_assert(sizeof(FBinaryGeometryHeader) == 44, "FBinaryGeometryHeader must match the Synavis layout");
+constexpr uint32 BinaryGeometryMagic = 0x424E5953u; // "SYNB"
+
+// mirror of Synavis::CheckedChunkHeader (synavis/DataConnector.hpp)
+#pragma pack(push, 1)
+struct FCheckedChunkHeader
+{
+  uint32 Magic;
+  uint32 Index;
+  uint32 Length;
+  uint32 Crc; // crc32c of the payload
+};
+#pragma pack(pop)
+static_assert(sizeof(FCheckedChunkHeader) == 16, "FCheckedChunkHeader must match the Synavis layout");
+constexpr uint32 CheckedChunkMagic = 0x434E5953u; // "SYNC"
+
+// crc32c (castagnoli), bytewise, the engine only provides the ieee polynomial
+static uint32 Crc32c(const uint8* Data, uint64 Length)
+{
+  static const TArray<uint32> Table = []()
+  {
+    TArray<uint32> Result;
+    Result.SetNum(256);
+    for (uint32 i = 0; i < 256; ++i)
+    {
+      uint32 Crc = i;
+      for (int Bit = 0; Bit < 8; ++Bit)
+        Crc = (Crc >> 1) ^ ((Crc & 1u) ? 0x82F63B78u : 0u);
+      Result[i] = Crc;
+    }
+    return Result;
+  }();
+  uint32 Crc = ~0u;
+  for (uint64 i = 0; i < Length; ++i)
+    Crc = (Crc >> 8) ^ Table[(Crc ^ Data[i]) & 0xFF];
+  return ~Crc;
+}
+
+inline double ReadBinaryElement(const uint8* Data, uint8 ElementType, uint64 Index)
+{
+  switch (ElementType)
+  {
+  case 0:
+    return reinterpret_cast<const float*>(Data)[Index];
+  case 1:
+    return reinterpret_cast<const double*>(Data)[Index];
+  case 2:
+    return reinterpret_cast<const int32*>(Data)[Index];
+  default:
+    return reinterpret_cast<const uint32*>(Data)[Index];
+  }
+}
+
+void ASynavisDrone::ReceiveBinaryGeometry(const uint8* Data, uint64 Length, double unixtime_start)
+{
+  FBinaryGeometryHeader Header;
+  FMemory::Memcpy(&Header, Data, sizeof(Header));
+  Header.Name[15] = '\0';
+  const FString Name(ANSI_TO_TCHAR(Header.Name));
+  const uint64 ElementSize = (Header.ElementType == 1) ? 8 : 4;
+  const int TransferId = (Header.TransferId > 0) ? Header.TransferId : -1;
+  if (Header.ElementType > 3 || sizeof(Header) + Header.Count * ElementSize > Length || Header.Offset > Header.Total || Header.Count > Header.Total - Header.Offset)
+  {
+    UE_LOG(LogTemp, Warning, TEXT("Malformed binary geometry frame for %s"), *Name);
+    SendError("Malformed binary geometry frame", TransferId);
+    return;
+  }
+  const uint8* Payload = Data + sizeof(Header);
+  // the arrays are allocated by the first frame of a transfer and remember its id. The later
+  // frames must belong to the same transfer and fit into the array as it was allocated
+  auto Prepare = [this, &Header, &Name, TransferId](auto& Target, uint64 Components) -> bool
+  {
+    if (Header.Total % Components != 0 || Header.Total / Components > static_cast<uint64>(MAX_int32))
+      return false;
+    if (Header.Offset == 0)
+    {
+      Target.SetNum(static_cast<int32>(Header.Total / Components));
+      GeometryTransfers.Add(Name, TransferId);
+    }
+    else
+    {
+      const int* Owner = GeometryTransfers.Find(Name);
+      if (Owner == nullptr || *Owner != TransferId || static_cast<uint64>(Target.Num()) * Components != Header.Total)
+        return false;
+    }
+    const uint64 Capacity = static_cast<uint64>(Target.Num()) * Components;
+    return Header.Offset <= Capacity && Header.Count <= Capacity - Header.Offset;
+  };
+  auto Reject = [this, &Name, TransferId]()
+  {
+    UE_LOG(LogTemp, Warning, TEXT("Binary geometry frame for %s does not fit its array"), *Name);
+    SendError("Binary geometry frame does not fit its array", TransferId);
+  };
+  // the components are written one by one
+  auto Fill = [&Header, Payload](double* Target)
+  {
+    for (uint64 i = 0; i < Header.Count; ++i)
+    {
+      Target[Header.Offset + i] = ReadBinaryElement(Payload, Header.ElementType, i);
+    }
+  };
+  if (Name == "points" || Name == "normals")
+  {
+    auto& Target = (Name == "points") ? Points : Normals;
+    if (!Prepare(Target, 3))
+      return Reject();
+    if (Header.ElementType == 1)
+      FMemory::Memcpy(reinterpret_cast<double*>(Target.GetData()) + Header.Offset, Payload, Header.Count * ElementSize);
+    else
+      Fill(reinterpret_cast<double*>(Target.GetData()));
+  }
+  else if (Name == "uvs")
+  {
+    if (!Prepare(UVs, 2))
+      return Reject();
+    Fill(reinterpret_cast<double*>(UVs.GetData()));
+  }
+  else if (Name == "triangles")
+  {
+    if (!Prepare(Triangles, 1))
+      return Reject();
+    if (Header.ElementType >= 2)
+      FMemory::Memcpy(Triangles.GetData() + Header.Offset, Payload, Header.Count * ElementSize);
+    else
+      for (uint64 i = 0; i < Header.Count; ++i)
+        Triangles[Header.Offset + i] = static_cast<int32>(ReadBinaryElement(Payload, Header.ElementType, i));
+  }
+  else if (Name == "tangents")
+  {
+    if (!Prepare(Tangents, 3))
+      return Reject();
+    for (uint64 i = 0; i < Header.Count; ++i)
+    {
+      const uint64 Element = Header.Offset + i;
+      Tangents[Element / 3].TangentX[Element % 3] = ReadBinaryElement(Payload, Header.ElementType, i);
+      Tangents[Element / 3].bFlipTangentY = false;
+    }
+  }
+  else
+  {
+    UE_LOG(LogTemp, Warning, TEXT("Unknown buffer name %s"), *Name);
+    SendError("Unknown buffer name", TransferId);
+    return;
+  }
+  SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"transit\"}"), *Name), unixtime_start, TransferId);
+}
+
+void ASynavisDrone::ReceiveCheckedChunk(const uint8* Data, uint64 Length, double unixtime_start)
+{
+  FCheckedChunkHeader Header;
+  FMemory::Memcpy(&Header, Data, sizeof(Header));
+  const uint64 Offset = static_cast<uint64>(Header.Index) * ReceptionChunkSize;
+  if (ReceptionName.IsEmpty() || ReceptionChunkSize == 0 || sizeof(Header) + Header.Length > Length
+    || Header.Length > ReceptionChunkSize || Offset + Header.Length > ReceptionBufferSize
+    || static_cast<int32>(Header.Index / 8) >= ReceptionBitmap.Num())
+  {
+    UE_LOG(LogTemp, Warning, TEXT("Received chunk %u that does not belong to a buffer"), Header.Index);
+    SendError("Chunk does not belong to a buffer", ReceptionTransferId);
+    return;
+  }
+  const uint8* Payload = Data + sizeof(Header);
+  // a damaged chunk is not stored, the sender learns about it from the bitmap and sends it again
+  const bool bValid = Crc32c(Payload, Header.Length) == Header.Crc;
+  if (bValid)
+  {
+    FMemory::Memcpy(ReceptionBuffer + Offset, Payload, Header.Length);
+    ReceptionBitmap[Header.Index / 8] |= (1u << (Header.Index % 8));
+  }
+  else
+  {
+    UE_LOG(LogTemp, Warning, TEXT("Chunk %u of %s failed the checksum"), Header.Index, *ReceptionName);
+  }
+  SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"transit\", \"chunk\":%u, \"valid\":%s}"),
+    *ReceptionName, Header.Index, bValid ? TEXT("true") : TEXT("false")), unixtime_start, ReceptionTransferId);
+}
+
+bool ASynavisDrone::StoreContent(const FString& Key, const FString& Name, const FString& Kind)
+{
+  const uint8* Data = nullptr;
+  uint64 Size = 0;
+  if (Name == "points")
+  {
+    Data = reinterpret_cast<const uint8*>(Points.GetData());
+    Size = Points.Num() * sizeof(FVector);
+  }
+  else if (Name == "normals")
+  {
+    Data = reinterpret_cast<const uint8*>(Normals.GetData());
+    Size = Normals.Num() * sizeof(FVector);
+  }
+  else if (Name == "triangles")
+  {
+    Data = reinterpret_cast<const uint8*>(Triangles.GetData());
+    Size = Triangles.Num() * sizeof(int32);
+  }
+  else if (Name == "uvs")
+  {
+    Data = reinterpret_cast<const uint8*>(UVs.GetData());
+    Size = UVs.Num() * sizeof(FVector2D);
+  }
+  else if ((Name == "texture" || Name == "custom") && ReceptionName == Name)
+  {
+    Data = ReceptionBuffer;
+    Size = ReceptionBufferSize;
+  }
+  // tangents are converted on reception and do not hold the bytes that were sent
+  if (Data == nullptr || Size == 0)
+    return false;
+  ContentStore.Add(Key, FStoredContent{ Name, Kind, TArray<uint8>(Data, static_cast<int32>(Size)) });
+  return true;
+}
+
+void ASynavisDrone::ReleaseReceptionBuffer()
+{
+  if (bOwnsReceptionBuffer)
+  {
+    delete[] ReceptionBuffer;
+  }
+  ReceptionBuffer = nullptr;
+  bOwnsReceptionBuffer = false;
+}
+
+bool ASynavisDrone::PlaceContent(const FString& Key, const FString& Name, const FString& Kind)
+{
+  const FStoredContent* Stored = ContentStore.Find(Key);
+  // the bytes of another array or representation would be misread, the sender then sends it in full
+  if (Stored == nullptr || Stored->Name != Name || Stored->Kind != Kind)
+    return false;
+  const TArray<uint8>* Content = &Stored->Data;
+  const uint64 Size = Content->Num();
+  if (Name == "points")
+  {
+    Points.SetNum(Size / sizeof(FVector));
+    FMemory::Memcpy(Points.GetData(), Content->GetData(), Points.Num() * sizeof(FVector));
+  }
+  else if (Name == "normals")
+  {
+    Normals.SetNum(Size / sizeof(FVector));
+    FMemory::Memcpy(Normals.GetData(), Content->GetData(), Normals.Num() * sizeof(FVector));
+  }
+  else if (Name == "triangles")
+  {
+    Triangles.SetNum(Size / sizeof(int32));
+    FMemory::Memcpy(Triangles.GetData(), Content->GetData(), Triangles.Num() * sizeof(int32));
+  }
+  else if (Name == "uvs")
+  {
+    UVs.SetNum(Size / sizeof(FVector2D));
+    FMemory::Memcpy(UVs.GetData(), Content->GetData(), UVs.Num() * sizeof(FVector2D));
+  }
+  else if (Name == "texture" || Name == "custom")
+  {
+    // the buffer is applied and released by a later message as if it had been received
+    ReleaseReceptionBuffer();
+    ReceptionBuffer = new uint8[Size];
+    bOwnsReceptionBuffer = true;
+    FMemory::Memcpy(ReceptionBuffer, Content->GetData(), Size);
+    ReceptionBufferSize = Size;
+    ReceptionBufferOffset = Size;
+    ReceptionName = Name;
+    ReceptionFormat = TEXT("raw");
+  }
+  else
+  {
+    return false;
+  }
+  return true;
+}
+
 void ASynavisDrone::ParseInput(FString Descriptor)
 {
   double unixtime_start = (RespondWithTiming) ? FPlatformTime::Seconds() : -1;
@@ -140,6 +423,20 @@ void ASynavisDrone::ParseInput(FString Descriptor)
     SendError("Empty Descriptor");
     return;
   }
+  // binary geometry frames carry raw bytes that must not go through the string conversion
+  const uint64 DescriptorBytes = Descriptor.Len() * sizeof(TCHAR);
+  if (DescriptorBytes >= sizeof(FBinaryGeometryHeader)
+    && FMemory::Memcmp(*Descriptor, &BinaryGeometryMagic, sizeof(BinaryGeometryMagic)) == 0)
+  {
+    ReceiveBinaryGeometry(reinterpret_cast<const uint8*>(*Descriptor), DescriptorBytes, unixtime_start);
+    return;
+  }
+  if (DescriptorBytes >= sizeof(FCheckedChunkHeader)
+    && FMemory::Memcmp(*Descriptor, &CheckedChunkMagic, sizeof(CheckedChunkMagic)) == 0)
+  {
+    ReceiveCheckedChunk(reinterpret_cast<const uint8*>(*Descriptor), DescriptorBytes, unixtime_start);
+    return;
+  }
   // reinterpret the message as ASCII
   const auto* Data = reinterpret_cast<const char*>(*Descriptor);
   // parse into FString
@@ -175,7 +472,7 @@ void ASynavisDrone::ParseInput(FString Descriptor)
 
       FMemory::Memcpy(ReceptionBuffer + ReceptionBufferOffset, data, size);
       ReceptionBufferOffset += size;
-      SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"transit\"}"), *ReceptionName), unixtime_start);
+      SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"transit\"}"), *ReceptionName), unixtime_start, ReceptionTransferId);
     }
   }
 }
@@ -189,7 +486,23 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
     int pid = GetIntFieldOr(Jason, TEXT("pid"), -1);
     if (LogResponses)
       UE_LOG(LogTemp, Warning, TEXT("Received Message of Type %s"), *type);
-    if (type == "geometry")
+    if (type == "batch")
+    {
+      // messages that the Synavis DataConnector coalesced into one frame, handled in order
+      const TArray<TSharedPtr<FJsonValue>>* Entries;
+      if (Jason->TryGetArrayField(TEXT("m"), Entries))
+      {
+        for (const auto& Entry : *Entries)
+        {
+          const TSharedPtr<FJsonObject>* Inner;
+          if (Entry.IsValid() && Entry->TryGetObject(Inner))
+          {
+            JsonCommand(*Inner, unixtime_start);
+          }
+        }
+      }
+    }
+    else if (type == "geometry")
     {
       Points.Empty();
       Normals.Empty();
@@ -269,7 +582,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         if (!Jason->HasField(TEXT("append")) && !Jason->HasField(TEXT("hold")))
         {
           auto mesh = WorldSpawner->SpawnProcMesh(Points, Normals, Triangles, {}, 0.0, 1.0, UVs, {});
-          ApplyJSONToObject(mesh, Jason.Get());
+          ApplyJSONToObject(mesh, Jason.Get(), pid);
         }
       }
       // we consumed the input, delete the file
@@ -282,7 +595,12 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
     else if (type == "parameter")
     {
       auto* Target = this->GetObjectFromJSON(Jason);
-      ApplyJSONToObject(Target, Jason.Get());
+      if (Target == nullptr)
+      {
+        SendError("parameter request object not found", pid);
+        return;
+      }
+      ApplyJSONToObject(Target, Jason.Get(), pid);
       SendResponse("{\"type\":\"parameter\",\"name\":\"" + Target->GetName() + "\"}", unixtime_start, pid);
     }
     else if (type == "query")
@@ -353,13 +671,13 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
           FString Property = Jason->GetStringField(TEXT("property"));
           // join Name and Property
           Name = FString::Printf(TEXT("%s.%s"), *Name, *Property);
-          FString JsonData = GetJSONFromObjectProperty(Target, Property);
+          FString JsonData = GetJSONFromObjectProperty(Target, Property, pid);
           FString message = FString::Printf(TEXT("{\"type\":\"query\",\"name\":\"%s\",\"data\":%s}"), *Name, *JsonData);
           this->SendResponse(message, unixtime_start, pid);
         }
         else
         {
-          SendError("query request object not found");
+          SendError("query request object not found", pid);
           UE_LOG(LogTemp, Error, TEXT("query request object not found"))
         }
       }
@@ -375,7 +693,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         }
         else
         {
-          SendError("query request object not found");
+          SendError("query request object not found", pid);
           UE_LOG(LogTemp, Error, TEXT("query request object not found"))
         }
       }
@@ -386,7 +704,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       // we need values "object" and "property"
       if (!Jason->HasField(TEXT("object")) || !Jason->HasField(TEXT("property")))
       {
-        SendError("track request needs object and property fields");
+        SendError("track request needs object and property fields", pid);
         UE_LOG(LogTemp, Error, TEXT("track request needs object and property fields"))
       }
       else
@@ -396,7 +714,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         auto Object = this->GetObjectFromJSON(Jason);
         if (!Object)
         {
-          SendError("track request object not found");
+          SendError("track request object not found", pid);
           return;
         }
 
@@ -406,7 +724,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
             return Target.Object == Object && Target.Property->GetName() == PropertyName;
           }))
         {
-          SendError("track request already tracking this property");
+          SendError("track request already tracking this property", pid);
           return;
         }
 
@@ -423,7 +741,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
 
           if (!Property)
           {
-            SendError("track request Property not found");
+            SendError("track request Property not found", pid);
             return;
           }
 
@@ -438,7 +756,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       // we need values "object" and "property"
       if (!Jason->HasField(TEXT("object")) || !Jason->HasField(TEXT("property")))
       {
-        SendError("untrack request needs object and property fields");
+        SendError("untrack request needs object and property fields", pid);
         UE_LOG(LogTemp, Error, TEXT("untrack request needs object and property fields"))
       }
       else
@@ -448,13 +766,13 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         auto Object = this->GetObjectFromJSON(Jason);
         if (!Object)
         {
-          SendError("untrack request object not found");
+          SendError("untrack request object not found", pid);
           return;
         }
         auto Property = Object->GetClass()->FindPropertyByName(*PropertyName);
         if (!Property)
         {
-          SendError("untrack request Property not found");
+          SendError("untrack request Property not found", pid);
           return;
         }
         for (int i = 0; i < this->TransmissionTargets.Num(); ++i)
@@ -634,6 +952,11 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         FString RequestedObjectName = Jason->GetStringField(TEXT("object"));
         TArray<AActor*> FoundActors;
       }
+      else if (Jason->HasField(TEXT("capabilities")))
+      {
+        const FString Response = TEXT("{\"type\":\"info\",\"capabilities\":[\"binarygeometry\",\"resumable\",\"dedup\"]}");
+        SendResponse(Response, unixtime_start, pid);
+      }
       else if (Jason->HasField(TEXT("DataChannelSize")))
       {
         int DataChannelSize = Jason->GetIntegerField(TEXT("DataChannelSize"));
@@ -719,7 +1042,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       else
       {
         UE_LOG(LogTemp, Warning, TEXT("No world spawner available"));
-        SendError("No world spawner available");
+        SendError("No world spawner available", pid);
       }
     }
     else if (type == "texture")
@@ -730,7 +1053,9 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       if (!TexData.IsEmpty())
       {
         auto size = FBase64::GetDecodedDataSize(TexData);
+        ReleaseReceptionBuffer();
         ReceptionBuffer = new uint8[size];
+        bOwnsReceptionBuffer = true;
         FBase64::Decode(*TexData, size, ReceptionBuffer);
         ApplyOrStoreTexture(Jason);
       }
@@ -768,7 +1093,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       else
       {
         UE_LOG(LogTemp, Warning, TEXT("Unknown dtype %s"), *dtype);
-        SendError("Unknown dtype");
+        SendError("Unknown dtype", pid);
         return;
       }
     }
@@ -785,11 +1110,22 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         ReceptionFormat = Format;
         ReceptionName = name;
         ReceptionBufferOffset = 0;
+        // the chunks of the buffer are acknowledged with the id of the transfer
+        ReceptionTransferId = pid;
+        // resumable transfers place every chunk by its index and keep track of the intact ones
+        ReceptionChunkSize = Jason->HasField(TEXT("checksum")) ? static_cast<uint64>(GetIntFieldOr(Jason, TEXT("chunk"), 0)) : 0;
+        ReceptionBitmap.Reset();
+        if (ReceptionChunkSize > 0)
+        {
+          ReceptionBitmap.SetNumZeroed((GetIntFieldOr(Jason, TEXT("chunks"), 0) + 7) / 8);
+        }
         // if the format is binary, we do not need to do anything
         // if the format is base64, we need to decode the data and allocate a buffer
+        ReleaseReceptionBuffer();
         if (Format == "base64")
         {
           ReceptionBuffer = new uint8[size];
+          bOwnsReceptionBuffer = true;
         }
         else if (ReceptionName == "points")
         {
@@ -798,7 +1134,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         }
         else if (ReceptionName == "normals")
         {
-          Points.SetNum(size / sizeof(FVector));
+          Normals.SetNum(size / sizeof(FVector));
           ReceptionBuffer = reinterpret_cast<uint8*>(Normals.GetData());
         }
         else if (ReceptionName == "triangles")
@@ -814,15 +1150,52 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         else if (ReceptionName == "texture" || ReceptionName == "custom")
         {
           ReceptionBuffer = new uint8[size];
+          bOwnsReceptionBuffer = true;
         }
         else
         {
           UE_LOG(LogTemp, Warning, TEXT("Unknown buffer name %s"), *ReceptionName);
-          SendError("Unknown buffer name");
+          SendError("Unknown buffer name", pid);
           return;
         }
         SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"start\"}"), *name), unixtime_start, pid);
       }
+      else if (Jason->HasField(TEXT("reference")))
+      {
+        // an array that was sent before, the sender falls back to sending it in full on an error
+        name = Jason->GetStringField(TEXT("name"));
+        if (!PlaceContent(Jason->GetStringField(TEXT("reference")), name, Jason->GetStringField(TEXT("kind"))))
+        {
+          SendError("Unknown content reference", pid);
+          return;
+        }
+        SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"reference\"}"), *name), unixtime_start, pid);
+      }
+      else if (Jason->HasField(TEXT("store")))
+      {
+        name = Jason->GetStringField(TEXT("name"));
+        if (!StoreContent(Jason->GetStringField(TEXT("store")), name, Jason->GetStringField(TEXT("kind"))))
+        {
+          SendError("Buffer cannot be kept", pid);
+          return;
+        }
+        SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"stored\"}"), *name), unixtime_start, pid);
+      }
+      else if (Jason->HasField(TEXT("forget")))
+      {
+        const FString Key = Jason->GetStringField(TEXT("forget"));
+        if (Key == TEXT("all"))
+          ContentStore.Empty();
+        else
+          ContentStore.Remove(Key);
+      }
+      else if (Jason->HasField(TEXT("query")))
+      {
+        // the sender of a resumable transfer asks which chunks arrived intact
+        const FString Bitmap = FBase64::Encode(ReceptionBitmap.GetData(), ReceptionBitmap.Num());
+        SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"bitmap\", \"bitmap\":\"%s\"}"),
+          *ReceptionName, *Bitmap), unixtime_start, pid);
+      }
       else if (Jason->HasField(TEXT("stop")))
       {
         // compute the size of the output buffer
@@ -873,7 +1246,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
           else
           {
             UE_LOG(LogTemp, Warning, TEXT("Unknown buffer name %s"), *ReceptionName);
-            SendError("Unknown buffer name");
+            SendError("Unknown buffer name", pid);
             return;
           }
 
@@ -904,11 +1277,13 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
             // for debug purposes, we write the first 20 letters of the string onto log
             //UE_LOG(LogTemp, Warning, TEXT("First 20 letters of string: %s"), *Base64String.Left(20));
             //UE_LOG(LogTemp, Warning, TEXT("Last 20 letters of string: %s"), *Base64String.Right(20));
-            SendError("Could not decode base64 string");
+            SendError("Could not decode base64 string", pid);
             return;
           }
-          delete[] ReceptionBuffer;
+          ReleaseReceptionBuffer();
           ReceptionBuffer = OutputBuffer;
+          // only textures and custom buffers are decoded into a buffer of their own
+          bOwnsReceptionBuffer = (ReceptionName == "texture" || ReceptionName == "custom");
           name = Jason->GetStringField(TEXT("stop"));
           SendResponse(FString::Printf(TEXT("{\"type\":\"buffer\",\"name\":\"%s\", \"state\":\"stop\", \"amount\":%llu}"), *name, ReceptionBufferSize), unixtime_start, pid);
           ReceptionBufferSize = OutputSize;
@@ -917,7 +1292,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       }
       else
       {
-        SendError("buffer request needs start or stop field");
+        SendError("buffer request needs start or stop field", pid);
         return;
       }
     }
@@ -942,7 +1317,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         ReadPixelFlags.SetLinearToGamma(true);
         if (!Source->ReadPixels(CamData, ReadPixelFlags))
         {
-          SendError("Could not read pixels from camera");
+          SendError("Could not read pixels from camera", pid);
           return;
         }
         ReceptionFormat = FBase64::Encode(reinterpret_cast<uint8*>(CamData.GetData()), CamData.Num() * sizeof(FColor));
@@ -974,7 +1349,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
         UE_LOG(LogNet, Warning, TEXT("Received request for missing chunk %d"), missing_chunk);
         if (missing_chunk < 0 || missing_chunk >= ReceptionBufferSize)
         {
-          SendError("invalid chunk number");
+          SendError("invalid chunk number", pid);
           return;
         }
         else
@@ -1005,7 +1380,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
     {
       if (this->DataChannelMaxSize < 0)
       {
-        SendError("frame was requested but data channel size is not set");
+        SendError("frame was requested but data channel size is not set", pid);
         return;
       }
 
@@ -1034,8 +1409,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
       // this is mostly due to a previous texture buffer transmission
       // we need to apply the texture to the material
       ApplyOrStoreTexture(Jason);
-      delete[] ReceptionBuffer;
-      ReceptionBuffer = nullptr;
+      ReleaseReceptionBuffer();
       ReceptionBufferSize = 0;
       ReceptionName = "";
       ReceptionFormat = "";
@@ -1060,7 +1434,7 @@ void ASynavisDrone::JsonCommand(TSharedPtr<FJsonObject> Jason, double unixtime_s
   else
   {
     UE_LOG(LogTemp, Warning, TEXT("No type field in JSON"));
-    SendError(TEXT("No type field in JSON"));
+    SendError(TEXT("No type field in JSON"), GetIntFieldOr(Jason, TEXT("pid"), -1));
   }
 }
 
@@ -1200,10 +1574,10 @@ void ASynavisDrone::SendResponse(FString Descriptor, double StartTime, int Playe
   OnPixelStreamingResponse.Broadcast(Response);
 }
 
-void ASynavisDrone::SendError(FString Message)
+void ASynavisDrone::SendError(FString Message, int PlayerID)
 {
   FString Response = FString::Printf(TEXT("{\"type\":\"error\",\"message\":\"%s\"}"), *Message);
-  SendResponse(Response);
+  SendResponse(Response, -1.0, PlayerID);
 }
 
 void ASynavisDrone::ResetSynavisState()
@@ -1487,7 +1861,7 @@ FProperty* FindPropertyThatHasName(UObject* Object, FString Name)
   return nullptr;
 }
 
-void ASynavisDrone::ApplyJSONToObject(UObject* Object, FJsonObject* JSON)
+void ASynavisDrone::ApplyJSONToObject(UObject* Object, FJsonObject* JSON, int PlayerID)
 {
   // received a parameter update
   FString Name = JSON->GetStringField(TEXT("property"));
@@ -1580,7 +1954,7 @@ void ASynavisDrone::ApplyJSONToObject(UObject* Object, FJsonObject* JSON)
   else
   {
     UE_LOG(LogTemp, Warning, TEXT("Property %s not found"), *Name);
-    SendResponse(FString::Printf(TEXT("{\"type\":\"error\",\"message\":\"Property not found\", \"properties\":%s}"), *ListObjectPropertiesAsJSON(Object)));
+    SendResponse(FString::Printf(TEXT("{\"type\":\"error\",\"message\":\"Property not found\", \"properties\":%s}"), *ListObjectPropertiesAsJSON(Object)), -1.0, PlayerID);
   }
 }
 
@@ -1629,7 +2003,7 @@ UObject* ASynavisDrone::GetObjectFromJSON(TSharedPtr<FJsonObject> JSON)
   return nullptr;
 }
 
-FString ASynavisDrone::GetJSONFromObjectProperty(UObject* Object, FString PropertyName)
+FString ASynavisDrone::GetJSONFromObjectProperty(UObject* Object, FString PropertyName, int PlayerID)
 {
   USceneComponent* ComponentIdentity = Cast<USceneComponent>(Object);
   AActor* ActorIdentity = Cast<AActor>(Object);
@@ -1716,12 +2090,12 @@ FString ASynavisDrone::GetJSONFromObjectProperty(UObject* Object, FString Proper
     else
     {
       UE_LOG(LogTemp, Warning, TEXT("Property %s not vector, float, bool, or string"), *PropertyName);
-      SendResponse(TEXT("{\"type\":\"error\",\"message\":\"Property not vector, float, bool, or string\"}"));
+      SendError(TEXT("Property not vector, float, bool, or string"), PlayerID);
       return TEXT("{}");
     }
   }
   UE_LOG(LogTemp, Warning, TEXT("Property %s not found"), *PropertyName);
-  SendResponse(TEXT("{\"type\":\"error\",\"message\":\"Property not found\"}"));
+  SendError(TEXT("Property not found"), PlayerID);
   return TEXT("{}");
 }
 
@@ -2097,6 +2471,7 @@ void ASynavisDrone::EnsureDistancePreservation()
 void ASynavisDrone::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
   Super::EndPlay(EndPlayReason);
+  ReleaseReceptionBuffer();
   if (WorldSpawner)
   {
     WorldSpawner->ReceiveStreamingCommunicatorRef(nullptr);
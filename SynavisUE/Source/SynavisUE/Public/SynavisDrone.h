@@ -80,6 +80,15 @@ struct FTransmissionTarget
   FString Name;
 };
 
+// an array that the DataConnector refers to by its content hash, it is only placed as the
+// array and in the representation that it was received as
+struct FStoredContent
+{
+  FString Name;
+  FString Kind;
+  TArray<uint8> Data;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBlueprintSignallingCallback, EBlueprintSignalling, Signal);
 
 UCLASS(Config = Game)
@@ -94,6 +103,15 @@ public:
   void JsonCommand(TSharedPtr<FJsonObject> Jason, double start = -1);
 
   void ParseGeometryFromJson(TSharedPtr<FJsonObject> Jason);
+  // handles a frame that starts with the binary geometry header of the Synavis DataConnector
+  void ReceiveBinaryGeometry(const uint8* Data, uint64 Length, double unixtime_start = -1);
+  void ReceiveCheckedChunk(const uint8* Data, uint64 Length, double unixtime_start = -1);
+  // keeps the array that was last received as Name in the representation Kind, so that the DataConnector can refer to it by Key
+  bool StoreContent(const FString& Key, const FString& Name, const FString& Kind);
+  // places a kept array where an array received as Name would have been placed, fails if it was kept as another array or kind
+  bool PlaceContent(const FString& Key, const FString& Name, const FString& Kind);
+  // frees the reception buffer if it was allocated for it rather than pointing into one of the geometry arrays
+  void ReleaseReceptionBuffer();
   // Sets default values for this actor's properties
   ASynavisDrone();
 
@@ -110,7 +128,7 @@ public:
     void SendResponse(FString Message, double StartTime = -1.0, int PlayerID = -1);
 
   UFUNCTION(BlueprintCallable, Category = "Network")
-    void SendError(FString Message);
+    void SendError(FString Message, int PlayerID = -1);
 
   UFUNCTION(BlueprintCallable, Category = "Network")
     void ResetSynavisState();
@@ -133,11 +151,12 @@ public:
   UFUNCTION(BlueprintCallable, Category = "View")
     void StoreCameraBuffer(int BufferNumber, FString NameBase);
 
-  void ApplyJSONToObject(UObject* Object, FJsonObject* JSON);
+  // errors are answered with PlayerID, so that the request that caused them fails right away
+  void ApplyJSONToObject(UObject* Object, FJsonObject* JSON, int PlayerID = -1);
 
   UObject* GetObjectFromJSON(TSharedPtr<FJsonObject> JSON);
 
-  FString GetJSONFromObjectProperty(UObject* Object, FString PropertyName);
+  FString GetJSONFromObjectProperty(UObject* Object, FString PropertyName, int PlayerID = -1);
 
   void AppendToMesh(TSharedPtr<FJsonObject> Jason);
 
@@ -344,9 +363,18 @@ protected:
   int LastProgress = -1;
   FString ReceptionName;
   FString ReceptionFormat;
-  uint8* ReceptionBuffer; // this is normally a reinterpret of the below
+  uint8* ReceptionBuffer = nullptr; // this is normally a reinterpret of the below
+  // true if ReceptionBuffer was allocated with new[], false if it points into Points, Normals, Triangles or UVs
+  bool bOwnsReceptionBuffer = false;
   uint64_t ReceptionBufferSize;
   uint64_t ReceptionBufferOffset;
+  int ReceptionTransferId = -1;
+  // the transfer that allocated each binary geometry array, its frames are the only ones written into it
+  TMap<FString, int> GeometryTransfers;
+  uint64 ReceptionChunkSize = 0;
+  TArray<uint8> ReceptionBitmap;
+  // arrays that the DataConnector sends as references to their content hash
+  TMap<FString, FStoredContent> ContentStore;
   unsigned int PointCount = 0;
   unsigned int TriangleCount = 0;
 
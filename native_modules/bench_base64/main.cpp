@@ -0,0 +1,75 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+#include "Synavis.hpp"
+
+using namespace Synavis;
+
+// builds a vertex buffer that resembles a plant mesh: a stem with leaves along a spiral
+std::vector<double> PlantVertices(std::size_t Bytes)
+{
+  std::vector<double> vertices(Bytes / sizeof(double));
+  for (std::size_t i = 0; i + 2 < vertices.size(); i += 3)
+  {
+    const double t = static_cast<double>(i) * 1e-4;
+    vertices[i] = std::cos(t * 13.0) * (0.1 + 0.05 * std::sin(t));
+    vertices[i + 1] = std::sin(t * 13.0) * (0.1 + 0.05 * std::sin(t));
+    vertices[i + 2] = t;
+  }
+  return vertices;
+}
+
+// returns the throughput in GB/s of the best of Repetitions runs
+template < typename F >
+double Measure(F&& Function, std::size_t Bytes, int Repetitions = 5)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < Repetitions; ++r)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    Function();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return static_cast<double>(Bytes) / best / 1e9;
+}
+
+int main()
+{
+  const std::vector<std::size_t> sizes_mb = { 1, 5, 10, 25, 50 };
+  const std::vector<EBase64Backend> backends = { EBase64Backend::Scalar, EBase64Backend::SSSE3, EBase64Backend::AVX2 };
+  std::cout << "Detected backend: " << Base64BackendName() << std::endl;
+  std::cout << std::setw(8) << "MB" << std::setw(10) << "backend" << std::setw(14) << "encode GB/s" << std::setw(14) << "decode GB/s" << std::endl;
+  for (auto size : sizes_mb)
+  {
+    const auto vertices = PlantVertices(size * 1024 * 1024);
+    const std::span<const uint8_t> raw(reinterpret_cast<const uint8_t*>(vertices.data()), ByteSize(vertices));
+    std::string encoded(Base64EncodedLength(raw.size()), '\0');
+    std::vector<uint8_t> decoded(Base64DecodedLength(encoded.size()));
+    for (auto backend : backends)
+    {
+      // backends that the cpu does not support would silently measure the fallback
+      if (backend > Base64Backend())
+        continue;
+      std::size_t written = 0;
+      const double encode = Measure([&] { Base64Encode(raw.data(), raw.size(), encoded.data(), backend); }, raw.size());
+      const double decode = Measure([&] { Base64Decode(encoded, decoded.data(), written, backend); }, raw.size());
+      if (written != raw.size() || std::memcmp(decoded.data(), raw.data(), raw.size()) != 0)
+      {
+        std::cout << "Round trip failed for " << Base64BackendName(backend) << std::endl;
+        return 1;
+      }
+      std::cout << std::setw(8) << size << std::setw(10) << Base64BackendName(backend)
+        << std::setw(14) << std::fixed << std::setprecision(2) << encode
+        << std::setw(14) << decode << std::endl;
+    }
+  }
+  return 0;
+}
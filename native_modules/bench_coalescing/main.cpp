@@ -0,0 +1,131 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <cstring>
+#include <thread>
+#include <rtc/rtc.hpp>
+#include <json.hpp>
+
+#include "FramePool.hpp"
+#include "MessageBatcher.hpp"
+
+using namespace std::chrono_literals;
+using json = nlohmann::json;
+
+// Compares the throughput of tiny json commands sent one frame per message against
+// coalesced batch frames. Both peers live in this process and exchange their
+// descriptions directly, so no signalling server is needed.
+
+struct Loopback
+{
+  std::shared_ptr<rtc::PeerConnection> Sender;
+  std::shared_ptr<rtc::PeerConnection> Receiver;
+  std::shared_ptr<rtc::DataChannel> Outgoing;
+  std::shared_ptr<rtc::DataChannel> Incoming;
+};
+
+Loopback Connect()
+{
+  Loopback l;
+  rtc::Configuration config;
+  l.Sender = std::make_shared<rtc::PeerConnection>(config);
+  l.Receiver = std::make_shared<rtc::PeerConnection>(config);
+  auto sender = l.Sender.get();
+  auto receiver = l.Receiver.get();
+  l.Sender->onLocalDescription([receiver](rtc::Description d) { receiver->setRemoteDescription(d); });
+  l.Sender->onLocalCandidate([receiver](rtc::Candidate c) { receiver->addRemoteCandidate(c); });
+  l.Receiver->onLocalDescription([sender](rtc::Description d) { sender->setRemoteDescription(d); });
+  l.Receiver->onLocalCandidate([sender](rtc::Candidate c) { sender->addRemoteCandidate(c); });
+  std::promise<std::shared_ptr<rtc::DataChannel>> incoming;
+  l.Receiver->onDataChannel([&incoming](std::shared_ptr<rtc::DataChannel> dc) { incoming.set_value(dc); });
+  l.Outgoing = l.Sender->createDataChannel("bench");
+  std::promise<void> open;
+  l.Outgoing->onOpen([&open]() { open.set_value(); });
+  l.Incoming = incoming.get_future().get();
+  open.get_future().wait();
+  return l;
+}
+
+// the commands of one coupling step: a parameter change and the query of its result
+std::vector<std::string> MakeCommands(std::size_t Steps)
+{
+  std::vector<std::string> commands;
+  for (std::size_t i = 0; i < Steps; ++i)
+  {
+    commands.push_back(json({ {"type","parameter"},{"object","Plant" + std::to_string(i % 64)},{"property","Stress"},{"value", i * 0.01} }).dump());
+    commands.push_back(json({ {"type","query"},{"object","Plant" + std::to_string(i % 64)},{"property","Transpiration"} }).dump());
+  }
+  return commands;
+}
+
+double Run(Loopback& l, const std::vector<std::string>& Commands, bool Coalesce, std::size_t& Frames)
+{
+  std::atomic<std::size_t> received{ 0 };
+  std::promise<void> done;
+  const std::size_t expected = Commands.size();
+  l.Incoming->onMessage([&](rtc::message_variant data)
+    {
+      if (!std::holds_alternative<rtc::binary>(data))
+        return;
+      const auto& bytes = std::get<rtc::binary>(data);
+      const auto message = json::parse(std::string_view(reinterpret_cast<const char*>(bytes.data()) + 3, bytes.size() - 4));
+      const std::size_t count = (message["type"] == "batch") ? message["m"].size() : 1;
+      if ((received += count) == expected)
+        done.set_value();
+    });
+  Synavis::FramePool pool;
+  std::atomic<std::size_t> frames{ 0 };
+  auto Send = [&](std::string_view Payload)
+  {
+    auto frame = pool.Acquire(std::byte(50), Payload.size());
+    memcpy(frame.PayloadData(), Payload.data(), Payload.size());
+    l.Outgoing->sendBuffer(frame.Data());
+    frames++;
+  };
+  const auto start = std::chrono::steady_clock::now();
+  if (Coalesce)
+  {
+    Synavis::MessageBatcher batcher(Send, std::min<std::size_t>(l.Outgoing->maxMessageSize(), 65532) - 4, 2ms);
+    for (const auto& command : Commands)
+      batcher.Add(command);
+    batcher.Flush();
+  }
+  else
+  {
+    for (const auto& command : Commands)
+      Send(command);
+  }
+  if (done.get_future().wait_for(60s) != std::future_status::ready)
+  {
+    std::cout << "Timed out after " << received << " of " << expected << " messages" << std::endl;
+    return 0.0;
+  }
+  const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  Frames = frames;
+  return static_cast<double>(expected) / seconds;
+}
+
+int main()
+{
+  auto l = Connect();
+  std::cout << std::setw(10) << "messages" << std::setw(12) << "mode" << std::setw(10) << "frames" << std::setw(16) << "messages/s" << std::endl;
+  for (std::size_t steps : { 1000, 10000, 50000 })
+  {
+    const auto commands = MakeCommands(steps);
+    for (bool coalesce : { false, true })
+    {
+      std::size_t frames = 0;
+      const double rate = Run(l, commands, coalesce, frames);
+      std::cout << std::setw(10) << commands.size() << std::setw(12) << (coalesce ? "coalesced" : "single")
+        << std::setw(10) << frames << std::setw(16) << std::fixed << std::setprecision(0) << rate << std::endl;
+    }
+  }
+  l.Outgoing->close();
+  l.Sender->close();
+  l.Receiver->close();
+  return 0;
+}
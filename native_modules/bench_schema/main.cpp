@@ -0,0 +1,166 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+#include <json.hpp>
+#include "Synavis.hpp"
+#include "BinarySchema.hpp"
+
+using namespace Synavis;
+using json = nlohmann::json;
+
+// Compares the ways to put a tracked property on the wire: the json that the track messages
+// carry today, the hand-rolled InsertIntoBinary without a decoder, and a BinarySchema in the
+// byte order of the machine and in the opposite one
+
+struct TrackSample
+{
+  uint32_t Object;
+  double Time;
+  std::array<float, 3> Position;
+  std::array<float, 3> Rotation;
+  bool Visible;
+};
+
+using LittleSchema = BinarySchema<0x4B525453u, 1, EByteOrder::Little,
+  Field<&TrackSample::Object>, Field<&TrackSample::Time>, Field<&TrackSample::Position>,
+  Field<&TrackSample::Rotation>, Field<&TrackSample::Visible>>;
+using BigSchema = BinarySchema<0x4B525453u, 1, EByteOrder::Big,
+  Field<&TrackSample::Object>, Field<&TrackSample::Time>, Field<&TrackSample::Position>,
+  Field<&TrackSample::Rotation>, Field<&TrackSample::Visible>>;
+static_assert(LittleSchema::Size == 8 + 4 + 8 + 12 + 12 + 1, "The layout has no padding");
+
+std::vector<TrackSample> MakeSamples(std::size_t Count)
+{
+  std::vector<TrackSample> samples(Count);
+  for (std::size_t i = 0; i < Count; ++i)
+  {
+    const float f = static_cast<float>(i);
+    samples[i] = TrackSample{ static_cast<uint32_t>(i % 64), 1700000000.0 + i * 0.016,
+      { 10.5f * f, -3.25f, 112.0f + f }, { 0.0f, f * 0.1f, 90.0f }, i % 3 != 0 };
+  }
+  return samples;
+}
+
+bool Equal(const TrackSample& A, const TrackSample& B)
+{
+  return A.Object == B.Object && A.Time == B.Time && A.Position == B.Position && A.Rotation == B.Rotation && A.Visible == B.Visible;
+}
+
+// returns the nanoseconds per sample of the best of Repetitions runs
+template < typename F >
+double Measure(F&& Function, std::size_t Samples, int Repetitions = 5)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < Repetitions; ++r)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    Function();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best / static_cast<double>(Samples) * 1e9;
+}
+
+void Report(const std::string& Name, std::size_t Bytes, double Encode, double Decode)
+{
+  std::cout << std::setw(16) << Name << std::setw(8) << Bytes << std::setw(14) << std::fixed << std::setprecision(1)
+    << Encode << std::setw(14) << Decode << std::endl;
+}
+
+int main()
+{
+  constexpr std::size_t Count = 100000;
+  const auto samples = MakeSamples(Count);
+  std::vector<TrackSample> decoded(Count);
+  std::cout << std::setw(16) << "format" << std::setw(8) << "bytes" << std::setw(14) << "encode ns" << std::setw(14) << "decode ns" << std::endl;
+
+  {
+    std::vector<std::string> messages(Count);
+    const double encode = Measure([&]
+      {
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+          const auto& s = samples[i];
+          messages[i] = json{ {"type","track"},{"object",s.Object},{"time",s.Time},{"position",s.Position},
+            {"rotation",s.Rotation},{"visible",s.Visible} }.dump();
+        }
+      }, Count);
+    const double decode = Measure([&]
+      {
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+          const auto message = json::parse(messages[i]);
+          decoded[i] = TrackSample{ message["object"].get<uint32_t>(), message["time"].get<double>(),
+            message["position"].get<std::array<float, 3>>(), message["rotation"].get<std::array<float, 3>>(),
+            message["visible"].get<bool>() };
+        }
+      }, Count);
+    Report("json", messages[0].size(), encode, decode);
+  }
+
+  {
+    // InsertIntoBinary writes the fields in machine order, the reader has to mirror it by hand
+    constexpr std::size_t size = sizeof(uint32_t) + sizeof(double) + 2 * sizeof(std::array<float, 3>) + sizeof(bool);
+    std::vector<rtc::binary> messages(Count, rtc::binary(size));
+    const double encode = Measure([&]
+      {
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+          const auto& s = samples[i];
+          InsertIntoBinary(messages[i], 0, s.Object, s.Time, s.Position, s.Rotation, s.Visible);
+        }
+      }, Count);
+    const double decode = Measure([&]
+      {
+        for (std::size_t i = 0; i < Count; ++i)
+        {
+          const std::byte* data = messages[i].data();
+          auto& s = decoded[i];
+          std::memcpy(&s.Object, data, sizeof(s.Object));
+          std::memcpy(&s.Time, data + 4, sizeof(s.Time));
+          std::memcpy(s.Position.data(), data + 12, sizeof(s.Position));
+          std::memcpy(s.Rotation.data(), data + 24, sizeof(s.Rotation));
+          s.Visible = data[36] != std::byte{ 0 };
+        }
+      }, Count);
+    Report("InsertIntoBinary", size, encode, decode);
+  }
+
+  const auto run_schema = [&]<typename S>(const std::string& Name, S)
+    {
+      std::vector<rtc::binary> messages(Count, rtc::binary(S::Size));
+      const double encode = Measure([&]
+        {
+          for (std::size_t i = 0; i < Count; ++i)
+            S::Encode(samples[i], messages[i]);
+        }, Count);
+      bool valid = true;
+      const double decode = Measure([&]
+        {
+          for (std::size_t i = 0; i < Count; ++i)
+          {
+            const auto sample = S::Decode(messages[i]);
+            valid &= sample.has_value();
+            decoded[i] = sample.value_or(TrackSample{});
+          }
+        }, Count);
+      for (std::size_t i = 0; i < Count; ++i)
+        valid &= Equal(samples[i], decoded[i]);
+      Report(Name, S::Size, encode, decode);
+      return valid;
+    };
+  const std::string native = (std::endian::native == std::endian::little) ? "little" : "big";
+  const std::string swapped = (std::endian::native == std::endian::little) ? "big" : "little";
+  if (!run_schema("schema " + native, std::conditional_t<std::endian::native == std::endian::little, LittleSchema, BigSchema>{})
+    || !run_schema("schema " + swapped, std::conditional_t<std::endian::native == std::endian::little, BigSchema, LittleSchema>{}))
+  {
+    std::cout << "Decoded samples differ from the encoded ones" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <span>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+#include "Utf16.hpp"
+
+using namespace Synavis;
+
+// Measures the conversion of the wide responses that the Unreal plugin sends. A file with
+// one recorded message per line (as the message callback prints them) may be given as
+// argument, otherwise messages are built from the formats that SynavisDrone.cpp prints.
+
+// Unreal sends the FString with its utf-16 code units in little endian order
+std::vector<uint8_t> Widen(const std::u16string& Text)
+{
+  std::vector<uint8_t> wide;
+  wide.reserve(Text.size() * 2);
+  for (char16_t unit : Text)
+  {
+    wide.push_back(static_cast<uint8_t>(unit & 0xFF));
+    wide.push_back(static_cast<uint8_t>(unit >> 8));
+  }
+  return wide;
+}
+
+std::u16string FromUtf8(const std::string& Text)
+{
+  std::u16string result;
+  for (std::size_t i = 0; i < Text.size();)
+  {
+    const auto c = static_cast<unsigned char>(Text[i]);
+    const std::size_t length = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    uint32_t code = length == 1 ? c : c & (0x7F >> length);
+    for (std::size_t k = 1; k < length && i + k < Text.size(); ++k)
+      code = (code << 6) | (static_cast<unsigned char>(Text[i + k]) & 0x3F);
+    i += length;
+    if (code >= 0x10000)
+    {
+      code -= 0x10000;
+      result.push_back(static_cast<char16_t>(0xD800 + (code >> 10)));
+      result.push_back(static_cast<char16_t>(0xDC00 + (code & 0x3FF)));
+    }
+    else
+    {
+      result.push_back(static_cast<char16_t>(code));
+    }
+  }
+  return result;
+}
+
+std::vector<std::string> PluginMessages()
+{
+  std::vector<std::string> messages;
+  for (int i = 0; i < 64; ++i)
+  {
+    const std::string plant = "Plant" + std::to_string(i);
+    messages.push_back("{\"type\":\"track\",\"time\":" + std::to_string(1700000000 + i)
+      + ",\"data\":{\"" + plant + ".Transpiration\":" + std::to_string(0.0123 * i)
+      + ",\"" + plant + ".Position\":{\"x\":" + std::to_string(10.5 * i) + ",\"y\":-3.250000,\"z\":112.000000}}}");
+    messages.push_back("{\"type\":\"buffer\",\"name\":\"points\", \"state\":\"transit\", \"chunk\":" + std::to_string(i)
+      + ", \"valid\":true, \"processed_time\":3, \"player_id\":" + std::to_string(i % 7 + 1) + "}");
+    messages.push_back("{\"type\":\"frametime\",\"value\":0.016" + std::to_string(i % 10) + "000}");
+  }
+  // actor names are not restricted to ascii
+  messages.push_back("{\"type\":\"query\",\"name\":\"spawn\",\"data\":[\"Blattfläche_Süd\",\"Wurzelgröße\",\"Ähre_03\"]}");
+  messages.push_back("{\"type\":\"error\",\"message\":\"Property not found\", \"properties\":{\"Name\":\"植物\",\"Tag\":\"🌱\"}}");
+  return messages;
+}
+
+// returns the throughput in MB/s of the best of Repetitions runs
+template < typename F >
+double Measure(F&& Function, std::size_t Bytes, int Repetitions = 5)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int r = 0; r < Repetitions; ++r)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    Function();
+    best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  }
+  return static_cast<double>(Bytes) / best / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> messages;
+  if (argc > 1)
+  {
+    std::ifstream file(argv[1]);
+    for (std::string line; std::getline(file, line);)
+    {
+      if (!line.empty())
+        messages.push_back(line);
+    }
+  }
+  if (messages.empty())
+    messages = PluginMessages();
+  std::vector<std::vector<uint8_t>> payloads;
+  std::size_t bytes = 0;
+  for (const auto& message : messages)
+  {
+    payloads.push_back(Widen(FromUtf8(message)));
+    bytes += payloads.back().size();
+  }
+  constexpr int Rounds = 2000;
+  std::cout << "Detected backend: " << Utf16BackendName() << std::endl;
+  std::cout << payloads.size() << " messages, " << bytes / payloads.size() << " bytes on average" << std::endl;
+  std::cout << std::setw(10) << "backend" << std::setw(12) << "MB/s" << std::setw(14) << "ns/message" << std::endl;
+
+  // what the data connector did before: every second byte into a new array, non ascii text is lost
+  std::string narrow;
+  const double naive = Measure([&]
+    {
+      for (int round = 0; round < Rounds; ++round)
+        for (const auto& payload : payloads)
+        {
+          char* cstr = new char[payload.size() / 2];
+          for (std::size_t i = 0; i < payload.size() / 2; ++i)
+            cstr[i] = static_cast<char>(payload[2 * i]);
+          narrow.assign(cstr, payload.size() / 2);
+          delete[] cstr;
+        }
+    }, bytes * Rounds);
+  std::cout << std::setw(10) << "naive" << std::setw(12) << std::fixed << std::setprecision(1) << naive
+    << std::setw(14) << static_cast<double>(bytes) / naive * 1e3 / payloads.size() << std::endl;
+
+  std::string reference;
+  for (auto backend : { EUtf16Backend::Scalar, EUtf16Backend::SSE2, EUtf16Backend::AVX2 })
+  {
+    // backends that the cpu does not support would silently measure the fallback
+    if (backend > Utf16Backend())
+      continue;
+    std::string converted;
+    std::string all;
+    for (const auto& payload : payloads)
+    {
+      Utf16ToUtf8(payload, converted, backend);
+      all += converted;
+    }
+    if (backend == EUtf16Backend::Scalar)
+      reference = all;
+    else if (all != reference)
+    {
+      std::cout << "Conversion differs for " << Utf16BackendName(backend) << std::endl;
+      return 1;
+    }
+    const double rate = Measure([&]
+      {
+        for (int round = 0; round < Rounds; ++round)
+          for (const auto& payload : payloads)
+            Utf16ToUtf8(payload, converted, backend);
+      }, bytes * Rounds);
+    std::cout << std::setw(10) << Utf16BackendName(backend) << std::setw(12) << rate
+      << std::setw(14) << static_cast<double>(bytes) / rate * 1e3 / payloads.size() << std::endl;
+  }
+  return 0;
+}
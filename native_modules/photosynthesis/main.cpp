@@ -986,6 +986,11 @@ int main(int argc, char** argv)
   auto m = std::make_shared<Synavis::DataConnector>();
   m->SetConfig({ {"SignallingIP", ip_address}, {"SignallingPort", sig_port} });
   m->SetTakeFirstStep(false);
+  // identical arrays of same-topology plants are sent as references once the peer holds them
+  if (parser.HasArgument("dedup"))
+  {
+    m->SetDeduplication(true);
+  }
   m->Initialize();
   m->StartSignalling();
   m->LockUntilConnected(800);
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <vector>
+#include <span>
+#include <thread>
+
+#include "MessageAssembler.hpp"
+
+using namespace Synavis;
+
+int main()
+{
+  std::vector<rtc::binary> delivered;
+  MessageAssembler assembler([&delivered](rtc::binary Data) { delivered.push_back(std::move(Data)); });
+  std::vector<std::byte> message(250);
+  for (std::size_t i = 0; i < message.size(); ++i)
+    message[i] = static_cast<std::byte>(i);
+  auto piece = [&message](uint32_t Sequence, std::size_t Size) { return std::span<const std::byte>(message).subspan(Sequence * 100, Size); };
+
+  // headers that do not describe Count pieces of PieceSize, or pieces of the wrong size
+  struct Invalid { uint32_t Sequence, Count, PieceSize; uint64_t Total; std::size_t Size; const char* Reason; };
+  const std::vector<Invalid> invalid = {
+    { 0, 0, 100, 250, 100, "no pieces" },
+    { 3, 3, 100, 250, 50, "sequence beyond count" },
+    { 0, 3, 0, 250, 0, "empty pieces" },
+    { 0, 3, 100, 200, 100, "total fits into fewer pieces" },
+    { 0, 3, 100, 301, 100, "total beyond the pieces" },
+    { 0, 3, 100, 250, 99, "short piece" },
+    { 2, 3, 100, 250, 49, "short last piece" },
+    { 0, 0xFFFFFFFFu, 0xFFFFFFFFu, ~0ull, 100, "huge total" }
+  };
+  for (const auto& header : invalid)
+  {
+    if (assembler.Insert(1, header.Sequence, header.Count, header.PieceSize, header.Total, std::span<const std::byte>(message).first(header.Size)))
+    {
+      std::cout << "MessageAssembler accepted a piece with " << header.Reason << std::endl;
+      return 1;
+    }
+  }
+  if (assembler.GetPendingCount() != 0 || !delivered.empty())
+  {
+    std::cout << "MessageAssembler kept an invalid piece" << std::endl;
+    return 1;
+  }
+
+  // out of order with a duplicate, the message is delivered once and in order
+  if (!assembler.Insert(2, 2, 3, 100, 250, piece(2, 50)) || !assembler.Insert(2, 0, 3, 100, 250, piece(0, 100))
+    || !assembler.Insert(2, 0, 3, 100, 250, piece(0, 100)) || !delivered.empty()
+    || !assembler.Insert(2, 1, 3, 100, 250, piece(1, 100)))
+  {
+    std::cout << "MessageAssembler rejected valid pieces" << std::endl;
+    return 1;
+  }
+  if (delivered.size() != 1 || delivered[0] != rtc::binary(message.begin(), message.end()) || assembler.GetDeliveredCount() != 1)
+  {
+    std::cout << "MessageAssembler did not deliver the message exactly once" << std::endl;
+    return 1;
+  }
+  // a piece that disagrees with the first piece of its message
+  if (!assembler.Insert(3, 0, 3, 100, 250, piece(0, 100)) || assembler.Insert(3, 1, 2, 100, 200, piece(1, 100)))
+  {
+    std::cout << "MessageAssembler mixed pieces of different messages" << std::endl;
+    return 1;
+  }
+
+  assembler.SetStaleTimeout(std::chrono::milliseconds(10));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  if (assembler.DiscardStale() != 1 || assembler.GetPendingCount() != 0 || assembler.GetPendingBytes() != 0)
+  {
+    std::cout << "MessageAssembler did not discard a stale message" << std::endl;
+    return 1;
+  }
+  assembler.SetStaleTimeout(std::chrono::seconds(10));
+
+  assembler.SetMaxTotal(200);
+  if (assembler.Insert(4, 0, 3, 100, 250, piece(0, 100)) || !assembler.Insert(4, 0, 2, 100, 200, piece(0, 100)))
+  {
+    std::cout << "MessageAssembler did not honor the largest message size" << std::endl;
+    return 1;
+  }
+  // the second message only fits once the first is evicted
+  assembler.SetMaxPendingBytes(300);
+  if (!assembler.Insert(5, 0, 2, 100, 200, piece(0, 100)) || assembler.GetPendingCount() != 1 || assembler.GetPendingBytes() != 200
+    || assembler.Insert(6, 0, 4, 100, 400, piece(0, 100)))
+  {
+    std::cout << "MessageAssembler did not keep to its budget" << std::endl;
+    return 1;
+  }
+  if (!assembler.Insert(5, 1, 2, 100, 200, piece(1, 100)) || delivered.size() != 2 || assembler.GetPendingBytes() != 0)
+  {
+    std::cout << "MessageAssembler lost the message that fit into its budget" << std::endl;
+    return 1;
+  }
+  // a single empty piece is a message without bytes
+  if (!assembler.Insert(7, 0, 1, 100, 0, {}) || delivered.size() != 3 || !delivered.back().empty())
+  {
+    std::cout << "MessageAssembler did not deliver an empty message" << std::endl;
+    return 1;
+  }
+  std::cout << "All assembler tests passed" << std::endl;
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <vector>
 #include <span>
+#include <random>
 
 #include "Synavis.hpp"
 
@@ -18,7 +19,6 @@ int main()
     std::cout << "Got: " << encoded << std::endl;
     return 1;
   }
-  delete [] encoded.data();
   std::vector<float> fdata = {1.0, 2.0, 3.0, 4.0};
   encoded = Encode64(fdata);
   if(encoded != "AACAPwAAAEAAAEBAAACAQA==")
@@ -55,4 +55,47 @@ int main()
     std::cout << "Got: " << encoded << std::endl;
     return 1;
   }
+  if(Decode64<double>(Encode64(ddata)) != ddata || Decode64<int16_t>(Encode64(sdata)) != sdata)
+  {
+    std::cout << "Decode64 failed" << std::endl;
+    return 1;
+  }
+  if(Base64Decode("AQACAAMABAA").size() != 8)
+  {
+    std::cout << "Decoding unpadded input failed" << std::endl;
+    return 1;
+  }
+  std::size_t written = 0;
+  std::vector<uint8_t> sink(16);
+  if(Base64Decode("AQAC*AMABAA=", sink.data(), written) || Base64Decode("AQ=CAAMA", sink.data(), written))
+  {
+    std::cout << "Invalid input was accepted" << std::endl;
+    return 1;
+  }
+  // all backends must agree with the scalar reference, sizes cover the vector loop tails
+  std::cout << "Base64 backend: " << Base64BackendName() << std::endl;
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for(std::size_t size = 0; size < 300; ++size)
+  {
+    std::vector<uint8_t> data(size);
+    for(auto& b : data)
+      b = static_cast<uint8_t>(byte(rng));
+    const auto reference = Base64Encode(data, EBase64Backend::Scalar);
+    for(auto backend : {EBase64Backend::SSSE3, EBase64Backend::AVX2})
+    {
+      if(Base64Encode(data, backend) != reference)
+      {
+        std::cout << "Encoding with " << Base64BackendName(backend) << " differs at size " << size << std::endl;
+        return 1;
+      }
+      if(Base64Decode(reference, backend) != data)
+      {
+        std::cout << "Decoding with " << Base64BackendName(backend) << " differs at size " << size << std::endl;
+        return 1;
+      }
+    }
+  }
+  std::cout << "All base64 tests passed" << std::endl;
+  return 0;
 }
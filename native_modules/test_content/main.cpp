@@ -0,0 +1,106 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <span>
+#include <algorithm>
+
+#include "ContentCache.hpp"
+
+using namespace Synavis;
+
+std::span<const uint8_t> Bytes(const std::string& Text)
+{
+  return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Text.data()), Text.size());
+}
+
+int main()
+{
+  // reference values of XXH64 with seed 0, the peer has to be able to compute the same keys
+  const std::vector<std::pair<std::string, uint64_t>> vectors = {
+    { "", 0xef46db3751d8e999ull },
+    { "abc", 0x44bc2cf5ad770999ull },
+    { "Nobody inspects the spammish repetition", 0xfbcea83c8a378bf1ull }
+  };
+  for (const auto& [text, expected] : vectors)
+  {
+    const auto hash = ContentHash(Bytes(text));
+    if (hash != expected)
+    {
+      std::cout << "ContentHash failed for \"" << text << "\"" << std::endl;
+      std::cout << "Expected: " << ContentKey(expected) << std::endl;
+      std::cout << "Got: " << ContentKey(hash) << std::endl;
+      return 1;
+    }
+  }
+  if (ContentHash(Bytes("abc"), 1) == ContentHash(Bytes("abc")))
+  {
+    std::cout << "ContentHash ignores the seed" << std::endl;
+    return 1;
+  }
+  if (ContentKey(0xef46db3751d8e999ull) != "ef46db3751d8e999" || ContentKey(0x1ull) != "0000000000000001")
+  {
+    std::cout << "ContentKey failed" << std::endl;
+    std::cout << "Got: " << ContentKey(0xef46db3751d8e999ull) << " and " << ContentKey(0x1ull) << std::endl;
+    return 1;
+  }
+
+  ContentCache cache(300);
+  if (!cache.Insert(1, 100).empty() || !cache.Insert(2, 100).empty() || !cache.Insert(3, 100).empty())
+  {
+    std::cout << "ContentCache evicted within its budget" << std::endl;
+    return 1;
+  }
+  // 1 becomes the most recently used, so 2 is the one to go
+  if (!cache.Touch(1, 100))
+  {
+    std::cout << "ContentCache lost a content within its budget" << std::endl;
+    return 1;
+  }
+  auto evicted = cache.Insert(4, 100);
+  if (evicted != std::vector<uint64_t>{ 2 } || cache.Touch(2, 100) || cache.GetBytes() != 300 || cache.Size() != 3)
+  {
+    std::cout << "ContentCache did not evict the least recently used content" << std::endl;
+    return 1;
+  }
+  // a different size can only be a collision
+  if (cache.Touch(1, 99))
+  {
+    std::cout << "ContentCache matched a content of another size" << std::endl;
+    return 1;
+  }
+  // contents beyond the budget are not kept and do not push out others
+  if (!cache.Insert(5, 301).empty() || cache.Touch(5, 301) || cache.Size() != 3)
+  {
+    std::cout << "ContentCache kept a content beyond its budget" << std::endl;
+    return 1;
+  }
+  // the order is 4, 1, 3 from the most recently used on
+  evicted = cache.SetBudget(150);
+  std::ranges::sort(evicted);
+  if (evicted != std::vector<uint64_t>{ 1, 3 } || cache.GetBytes() != 100 || !cache.Touch(4, 100) || cache.GetBudget() != 150)
+  {
+    std::cout << "ContentCache did not shrink to its new budget" << std::endl;
+    return 1;
+  }
+  evicted = cache.Insert(6, 100);
+  if (evicted != std::vector<uint64_t>{ 4 } || !cache.Touch(6, 100))
+  {
+    std::cout << "ContentCache did not make room for a new content" << std::endl;
+    return 1;
+  }
+  cache.Erase(6);
+  if (cache.Size() != 0 || cache.GetBytes() != 0)
+  {
+    std::cout << "ContentCache did not erase a content" << std::endl;
+    return 1;
+  }
+  cache.Insert(7, 50);
+  cache.Clear();
+  if (cache.Size() != 0 || cache.GetBytes() != 0 || cache.Touch(7, 50))
+  {
+    std::cout << "ContentCache did not clear" << std::endl;
+    return 1;
+  }
+  std::cout << "All content tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <optional>
+
+#include "JsonView.hpp"
+
+using namespace Synavis;
+
+int Failures = 0;
+
+template < typename T >
+void Expect(const std::string& What, const std::optional<T>& Got, const std::optional<T>& Expected)
+{
+  if (Got == Expected)
+    return;
+  std::cout << What << " failed" << std::endl;
+  if (Expected.has_value())
+    std::cout << "Expected: " << Expected.value() << std::endl;
+  else
+    std::cout << "Expected: nothing" << std::endl;
+  if (Got.has_value())
+    std::cout << "Got: " << Got.value() << std::endl;
+  else
+    std::cout << "Got: nothing" << std::endl;
+  Failures++;
+}
+
+void Expect(const std::string& What, bool Condition)
+{
+  if (Condition)
+    return;
+  std::cout << What << " failed" << std::endl;
+  Failures++;
+}
+
+int main()
+{
+  using sv = std::string_view;
+
+  // members behind strings with escaped quotes and backslashes and behind nested values
+  const std::string message = R"( { "name" : "a \"quoted\" name\\", "nested":{"type":"inner","list":[1,{"x":"}"},"]"]},
+    "data":"AAAA", "count":42 , "ratio":-1.5e2, "flag":true, "off":false, "none":null, "type":"buffer" } )";
+  const JsonView view(message);
+  Expect("IsObject", view.IsObject());
+  Expect("Type", std::optional<sv>(view.Type()), std::optional<sv>("buffer"));
+  Expect("String with escapes", view.String("name"), std::optional<sv>(R"(a \"quoted\" name\\)"));
+  Expect("Raw of a nested object", view.Raw("nested"), std::optional<sv>(R"({"type":"inner","list":[1,{"x":"}"},"]"]})"));
+  Expect("String behind a nested object", view.String("data"), std::optional<sv>("AAAA"));
+  Expect("Number as integer", view.Number<int>("count"), std::optional<int>(42));
+  Expect("Number as double", view.Number<double>("ratio"), std::optional<double>(-150.0));
+  Expect("Number of a fraction as integer", view.Number<int>("ratio"), std::optional<int>());
+  Expect("Number of a negative as unsigned", JsonView(R"({"n":-1})").Number<unsigned>("n"), std::optional<unsigned>());
+  Expect("Number of a string", view.Number<int>("data"), std::optional<int>());
+  Expect("Number of a missing member", view.Number<int>("missing"), std::optional<int>());
+  Expect("Bool true", view.Bool("flag"), std::optional<bool>(true));
+  Expect("Bool false", view.Bool("off"), std::optional<bool>(false));
+  Expect("Bool of null", view.Bool("none"), std::optional<bool>());
+  Expect("Raw of null", view.Raw("none"), std::optional<sv>("null"));
+  // only top-level members are found
+  Expect("Nested member is not top-level", view.Raw("list"), std::optional<sv>());
+  Expect("String of a number", view.String("count"), std::optional<sv>());
+  const auto nested = view.Object("nested");
+  Expect("Object", nested.has_value() && nested->Type() == "inner");
+  Expect("Object of a string", !view.Object("data").has_value());
+
+  std::vector<std::string> keys;
+  const bool complete = view.ForEachMember([&keys](sv Key, sv) { keys.emplace_back(Key); });
+  Expect("ForEachMember", complete && keys == std::vector<std::string>{ "name", "nested", "data", "count", "ratio", "flag", "off", "none", "type" });
+  Expect("Tree", view.Tree().is_object() && view.Tree()["count"] == 42 && view.Tree()["name"] == "a \"quoted\" name\\");
+
+  // "type" wins over the short "t" of the frame chunks, wherever it is
+  Expect("Short type", std::optional<sv>(JsonView(R"({"t":"frame","i":3})").Type()), std::optional<sv>("frame"));
+  Expect("Type over short type", std::optional<sv>(JsonView(R"({"t":"frame","type":"track"})").Type()), std::optional<sv>("track"));
+  Expect("Type that is no string", std::optional<sv>(JsonView(R"({"type":5,"t":"frame"})").Type()), std::optional<sv>("frame"));
+  Expect("Type of a nested member", std::optional<sv>(JsonView(R"({"data":{"type":"inner"}})").Type()), std::optional<sv>(""));
+  Expect("Empty object", JsonView("{}").IsObject() && JsonView("{ }").Type().empty() && !JsonView("{}").Contains("type"));
+
+  // malformed and truncated text yields nothing instead of reading past its end
+  const std::vector<std::string> malformed = {
+    "", "   ", "{", "{\"type\"", "{\"type\":", "{\"type\":\"buf",
+    "{\"type\" \"buffer\"}", "{type:\"buffer\"}", "{\"a\":{\"b\":[1,2}", "{\"a\":\"\\\"}", "{\"a\":1 \"type\":\"x\"}",
+    "{\"a\":,\"type\":\"x\"}", "{\"a\":\"x\\\\\\\"}"
+  };
+  for (const auto& text : malformed)
+  {
+    const JsonView broken(text);
+    Expect("Type of malformed " + text, broken.Type().empty());
+    Expect("Raw of malformed " + text, !broken.Raw("type").has_value());
+    Expect("ForEachMember of malformed " + text, !broken.ForEachMember([](sv, sv) {}));
+    Expect("Tree of malformed " + text, broken.Tree().is_discarded());
+  }
+  // valid json that is not an object has no members
+  for (const std::string text : { "[1,2]", "\"type\"", "42" })
+  {
+    const JsonView other(text);
+    Expect("IsObject of " + text, !other.IsObject() && other.Type().empty() && !other.ForEachMember([](sv, sv) {}));
+  }
+  // the members are read as far as they go, the damage behind them is reported by ForEachMember
+  const JsonView unterminated(R"({"type":"buffer","count":3)");
+  Expect("Type of unterminated", std::optional<sv>(unterminated.Type()), std::optional<sv>("buffer"));
+  Expect("Number of unterminated", unterminated.Number<int>("count"), std::optional<int>(3));
+  Expect("ForEachMember of unterminated", !unterminated.ForEachMember([](sv, sv) {}));
+  Expect("ForEachMember of empty object", JsonView(" { } ").ForEachMember([](sv, sv) {}));
+  // every prefix of a valid message is scanned without reading past it
+  for (std::size_t length = 0; length < message.size(); ++length)
+  {
+    const std::string prefix = message.substr(0, length);
+    const JsonView truncated(prefix);
+    truncated.ForEachMember([](sv, sv) {});
+    truncated.Number<double>("ratio");
+    truncated.Object("nested");
+  }
+
+  if (Failures > 0)
+    return 1;
+  std::cout << "All json view tests passed" << std::endl;
+  return 0;
+}
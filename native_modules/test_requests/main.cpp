@@ -0,0 +1,147 @@
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <limits>
+#include <stdexcept>
+
+#include "RequestTracker.hpp"
+
+using namespace Synavis;
+using json = nlohmann::json;
+
+// counts the completions of every request and keeps the last outcome
+struct Outcomes
+{
+  struct Outcome
+  {
+    int Calls{ 0 };
+    json Answer;
+    std::string Error;
+  };
+  std::mutex Mutex;
+  std::map<uint32_t, Outcome> ById;
+
+  RequestTracker::Completion For(uint32_t& Id)
+  {
+    return [this, &Id](json Answer, std::exception_ptr Error)
+      {
+        std::lock_guard<std::mutex> lock(Mutex);
+        auto& outcome = ById[Id];
+        outcome.Calls++;
+        outcome.Answer = std::move(Answer);
+        if (Error)
+        {
+          try { std::rethrow_exception(Error); }
+          catch (const std::exception& e) { outcome.Error = e.what(); }
+        }
+      };
+  }
+  Outcome Get(uint32_t Id)
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return ById[Id];
+  }
+};
+
+int Fail(const std::string& What)
+{
+  std::cout << What << " failed" << std::endl;
+  return 1;
+}
+
+std::string Answer(const std::string& Type, int64_t Id, const std::string& Extra = "")
+{
+  return "{\"type\":\"" + Type + "\"" + Extra + ",\"player_id\":" + std::to_string(Id) + "}";
+}
+
+int main()
+{
+  const auto later = RequestTracker::clock::now() + std::chrono::seconds(30);
+  Outcomes outcomes;
+  {
+    RequestTracker tracker;
+    uint32_t answered{}, failed{}, cancelled{}, expiring{}, remaining{};
+    answered = tracker.Open(later, outcomes.For(answered));
+    failed = tracker.Open(later, outcomes.For(failed));
+    cancelled = tracker.Open(later, outcomes.For(cancelled));
+    if (answered != RequestTracker::FirstId || failed != answered + 1 || tracker.GetPendingCount() != 3)
+      return Fail("Open");
+
+    // answers that belong to no request, transfer ids lie below FirstId
+    const std::string unrelated[] = { "{\"type\":\"query\"}", Answer("buffer", 7), Answer("query", answered + 100),
+      Answer("query", -1), Answer("query", int64_t{ 1 } << 40), "{\"type\":\"query\",\"player_id\":\"65536\"}" };
+    for (const auto& text : unrelated)
+      if (tracker.Complete(JsonView(text)))
+        return Fail("Complete of an unrelated answer " + text);
+
+    const std::string answer = Answer("query", answered, ",\"data\":{\"value\":3}");
+    if (!tracker.Complete(JsonView(answer)) || tracker.Complete(JsonView(answer)))
+      return Fail("Complete");
+    auto outcome = outcomes.Get(answered);
+    if (outcome.Calls != 1 || !outcome.Error.empty() || outcome.Answer["data"]["value"] != 3)
+      return Fail("Completion with the answer");
+
+    const std::string error = Answer("error", failed, ",\"message\":\"query request object not found\"");
+    if (!tracker.Complete(JsonView(error)))
+      return Fail("Complete of an error");
+    outcome = outcomes.Get(failed);
+    if (outcome.Calls != 1 || outcome.Error.find("query request object not found") == std::string::npos || !outcome.Answer.is_null())
+      return Fail("Completion with the error");
+
+    tracker.Fail(cancelled, std::make_exception_ptr(std::runtime_error("cancelled")));
+    tracker.Fail(cancelled, std::make_exception_ptr(std::runtime_error("cancelled again")));
+    if (outcomes.Get(cancelled).Calls != 1 || outcomes.Get(cancelled).Error != "cancelled" || tracker.HasPending())
+      return Fail("Fail");
+
+    // the deadline completes a request once, a late answer belongs to nothing
+    expiring = tracker.Open(RequestTracker::clock::now() + std::chrono::milliseconds(20), outcomes.For(expiring));
+    remaining = tracker.Open(later, outcomes.For(remaining));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    outcome = outcomes.Get(expiring);
+    if (outcome.Calls != 1 || outcome.Error.empty() || tracker.Complete(JsonView(Answer("query", expiring))))
+      return Fail("Deadline");
+    if (outcomes.Get(remaining).Calls != 0 || tracker.GetPendingCount() != 1)
+      return Fail("Deadline of another request");
+
+    tracker.FailAll(std::make_exception_ptr(std::runtime_error("closed")));
+    if (outcomes.Get(remaining).Calls != 1 || outcomes.Get(remaining).Error != "closed" || tracker.HasPending())
+      return Fail("FailAll");
+    tracker.FailAll(std::make_exception_ptr(std::runtime_error("closed again")));
+  }
+  // the ids of different trackers overlap, every tracker counts its own completions
+  Outcomes destruction;
+  uint32_t destroyed{};
+  {
+    // the destructor fails what is still open
+    RequestTracker tracker;
+    destroyed = tracker.Open(later, destruction.For(destroyed));
+  }
+  if (destruction.Get(destroyed).Calls != 1 || destruction.Get(destroyed).Error.empty())
+    return Fail("Destruction");
+  Outcomes wraparound;
+  {
+    // the ids start over behind the largest id the plugin can read
+    constexpr uint32_t largest = static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
+    RequestTracker tracker(largest);
+    uint32_t last{}, wrapped{};
+    last = tracker.Open(later, wraparound.For(last));
+    wrapped = tracker.Open(later, wraparound.For(wrapped));
+    if (last != largest || wrapped != RequestTracker::FirstId)
+      return Fail("Id wraparound");
+    if (!tracker.Complete(JsonView(Answer("query", last))) || wraparound.Get(last).Calls != 1 || wraparound.Get(wrapped).Calls != 0)
+      return Fail("Complete of the largest id");
+  }
+  {
+    RequestTracker tracker(0);
+    if (tracker.Open(later, [](json, std::exception_ptr) {}) != RequestTracker::FirstId)
+      return Fail("Ids below the request range");
+  }
+  for (auto* record : { &outcomes, &destruction, &wraparound })
+    for (const auto& [id, outcome] : record->ById)
+      if (outcome.Calls != 1)
+        return Fail("Request " + std::to_string(id) + " completed " + std::to_string(outcome.Calls) + " times,");
+  std::cout << "All request tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,356 @@
+#include "Base64.hpp"
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SYNAVIS_BASE64_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SYNAVIS_BASE64_X86 0
+#endif
+
+// gcc and clang only emit vector instructions for functions that are marked with the
+// respective target, msvc emits them whenever the intrinsics are used
+#if defined(__GNUC__) || defined(__clang__)
+#define SYNAVIS_TARGET(x) __attribute__((target(x)))
+#else
+#define SYNAVIS_TARGET(x)
+#endif
+
+namespace
+{
+  using Synavis::EBase64Backend;
+
+  constexpr char EncodeTable[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  constexpr uint8_t Invalid = 0xFF;
+
+  constexpr std::array<uint8_t, 256> MakeDecodeTable()
+  {
+    std::array<uint8_t, 256> table{};
+    for (auto& entry : table)
+      entry = Invalid;
+    for (uint8_t i = 0; i < 64; ++i)
+      table[static_cast<uint8_t>(EncodeTable[i])] = i;
+    return table;
+  }
+  constexpr std::array<uint8_t, 256> DecodeTable = MakeDecodeTable();
+
+  std::size_t EncodeScalar(const uint8_t* Source, std::size_t Length, char* Destination)
+  {
+    char* c = Destination;
+    std::size_t i = 0;
+    for (; i + 3 <= Length; i += 3)
+    {
+      const uint32_t triple = (uint32_t(Source[i]) << 16) | (uint32_t(Source[i + 1]) << 8) | Source[i + 2];
+      *c++ = EncodeTable[(triple >> 18) & 0x3F];
+      *c++ = EncodeTable[(triple >> 12) & 0x3F];
+      *c++ = EncodeTable[(triple >> 6) & 0x3F];
+      *c++ = EncodeTable[triple & 0x3F];
+    }
+    if (i < Length)
+    {
+      const bool two = (i + 1 < Length);
+      const uint32_t triple = (uint32_t(Source[i]) << 16) | (two ? (uint32_t(Source[i + 1]) << 8) : 0u);
+      *c++ = EncodeTable[(triple >> 18) & 0x3F];
+      *c++ = EncodeTable[(triple >> 12) & 0x3F];
+      *c++ = two ? EncodeTable[(triple >> 6) & 0x3F] : '=';
+      *c++ = '=';
+    }
+    return c - Destination;
+  }
+
+  // decodes quads until the end of the input, the last quad may be padded or cut short
+  bool DecodeScalar(const char* Source, std::size_t Length, uint8_t* Destination, std::size_t& Written)
+  {
+    // strip the padding, the remainder decides on how many bytes the last quad yields
+    if (Length > 0 && Source[Length - 1] == '=') --Length;
+    if (Length > 0 && Source[Length - 1] == '=') --Length;
+    if (Length % 4 == 1)
+      return false;
+    uint8_t* out = Destination;
+    std::size_t i = 0;
+    for (; i + 4 <= Length; i += 4)
+    {
+      const uint8_t a = DecodeTable[static_cast<uint8_t>(Source[i])];
+      const uint8_t b = DecodeTable[static_cast<uint8_t>(Source[i + 1])];
+      const uint8_t c = DecodeTable[static_cast<uint8_t>(Source[i + 2])];
+      const uint8_t d = DecodeTable[static_cast<uint8_t>(Source[i + 3])];
+      if (a == Invalid || b == Invalid || c == Invalid || d == Invalid)
+        return false;
+      const uint32_t quad = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+      *out++ = static_cast<uint8_t>(quad >> 16);
+      *out++ = static_cast<uint8_t>(quad >> 8);
+      *out++ = static_cast<uint8_t>(quad);
+    }
+    const std::size_t rest = Length - i;
+    if (rest > 0)
+    {
+      const uint8_t a = DecodeTable[static_cast<uint8_t>(Source[i])];
+      const uint8_t b = DecodeTable[static_cast<uint8_t>(Source[i + 1])];
+      const uint8_t c = (rest == 3) ? DecodeTable[static_cast<uint8_t>(Source[i + 2])] : 0;
+      if (a == Invalid || b == Invalid || c == Invalid)
+        return false;
+      const uint32_t quad = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+      *out++ = static_cast<uint8_t>(quad >> 16);
+      if (rest == 3)
+        *out++ = static_cast<uint8_t>(quad >> 8);
+    }
+    Written = out - Destination;
+    return true;
+  }
+
+#if SYNAVIS_BASE64_X86
+  // the vector paths follow the approach of W. Mula and D. Lemire:
+  // the 6-bit indices are extracted with two multiplications and mapped to ascii
+  // through a 16-entry offset table that pshufb can look up
+  SYNAVIS_TARGET("ssse3") inline __m128i EncodeLookupSSSE3(__m128i Indices)
+  {
+    const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    __m128i result = _mm_subs_epu8(Indices, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), Indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    result = _mm_shuffle_epi8(shift_lut, result);
+    return _mm_add_epi8(result, Indices);
+  }
+
+  SYNAVIS_TARGET("ssse3") std::size_t EncodeSSSE3(const uint8_t* Source, std::size_t Length, char* Destination)
+  {
+    const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    char* out = Destination;
+    std::size_t i = 0;
+    // 16 bytes are loaded but only 12 are consumed
+    for (; i + 16 <= Length; i += 12)
+    {
+      __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+      in = _mm_shuffle_epi8(in, shuffle);
+      const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+      const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+      const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+      const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), EncodeLookupSSSE3(_mm_or_si128(t1, t3)));
+      out += 16;
+    }
+    return (out - Destination) + EncodeScalar(Source + i, Length - i, out);
+  }
+
+  SYNAVIS_TARGET("avx2") std::size_t EncodeAVX2(const uint8_t* Source, std::size_t Length, char* Destination)
+  {
+    const __m256i shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+      10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m256i shift_lut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    char* out = Destination;
+    std::size_t i = 0;
+    // each lane consumes 12 bytes, the upper lane is loaded from an offset of 12
+    for (; i + 28 <= Length; i += 24)
+    {
+      const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+      const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i + 12));
+      __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      in = _mm256_shuffle_epi8(in, shuffle);
+      const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+      const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+      const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+      const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+      const __m256i indices = _mm256_or_si256(t1, t3);
+      __m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+      const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+      result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+      result = _mm256_shuffle_epi8(shift_lut, result);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(result, indices));
+      out += 32;
+    }
+    return (out - Destination) + EncodeSSSE3(Source + i, Length - i, out);
+  }
+
+  // the ascii ranges are classified by their nibbles, any character whose classes
+  // overlap is not part of the alphabet (this also rejects the padding character)
+  SYNAVIS_TARGET("ssse3") bool DecodeSSSE3(const char* Source, std::size_t Length, uint8_t* Destination, std::size_t& Written)
+  {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    uint8_t* out = Destination;
+    std::size_t i = 0;
+    for (; i + 16 <= Length; i += 16)
+    {
+      __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + i));
+      const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+      const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2f));
+      const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+      const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF)
+        break;
+      in = _mm_add_epi8(in, roll);
+      const __m128i merged = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+      const __m128i packed = _mm_shuffle_epi8(_mm_madd_epi16(merged, _mm_set1_epi32(0x00011000)), pack);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out), packed);
+      const int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(packed, 8));
+      std::memcpy(out + 8, &tail, sizeof(tail));
+      out += 12;
+    }
+    std::size_t rest = 0;
+    if (!DecodeScalar(Source + i, Length - i, out, rest))
+      return false;
+    Written = (out - Destination) + rest;
+    return true;
+  }
+
+  SYNAVIS_TARGET("avx2") bool DecodeAVX2(const char* Source, std::size_t Length, uint8_t* Destination, std::size_t& Written)
+  {
+    const __m256i lut_lo = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A));
+    const __m256i lut_hi = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+    const __m256i lut_roll = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+      0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+    const __m256i pack = _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    const __m256i gather = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+    uint8_t* out = Destination;
+    std::size_t i = 0;
+    for (; i + 32 <= Length; i += 32)
+    {
+      __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + i));
+      const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+      const __m256i lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, mask_2f));
+      const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+      const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(_mm256_cmpeq_epi8(in, mask_2f), hi_nibbles));
+      if (!_mm256_testz_si256(lo, hi))
+        break;
+      in = _mm256_add_epi8(in, roll);
+      const __m256i merged = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+      __m256i packed = _mm256_shuffle_epi8(_mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000)), pack);
+      // both lanes hold 12 bytes, move them next to each other
+      packed = _mm256_permutevar8x32_epi32(packed, gather);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(packed, 1));
+      out += 24;
+    }
+    std::size_t rest = 0;
+    if (!DecodeSSSE3(Source + i, Length - i, out, rest))
+      return false;
+    Written = (out - Destination) + rest;
+    return true;
+  }
+#endif
+
+  EBase64Backend DetectBackend()
+  {
+#if SYNAVIS_BASE64_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool ssse3 = (info[2] & (1 << 9)) != 0;
+    // avx2 also requires the os to save the ymm registers
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6)
+    {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool ssse3 = __builtin_cpu_supports("ssse3");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+      return EBase64Backend::AVX2;
+    if (ssse3)
+      return EBase64Backend::SSSE3;
+#endif
+    return EBase64Backend::Scalar;
+  }
+
+  EBase64Backend Resolve(EBase64Backend Requested)
+  {
+    const EBase64Backend available = Synavis::Base64Backend();
+    if (Requested == EBase64Backend::Automatic || Requested > available)
+      return available;
+    return Requested;
+  }
+}
+
+Synavis::EBase64Backend Synavis::Base64Backend()
+{
+  static const EBase64Backend detected = DetectBackend();
+  return detected;
+}
+
+std::string Synavis::Base64BackendName(EBase64Backend Backend)
+{
+  switch (Resolve(Backend))
+  {
+  case EBase64Backend::AVX2:
+    return "avx2";
+  case EBase64Backend::SSSE3:
+    return "ssse3";
+  default:
+    return "scalar";
+  }
+}
+
+std::size_t Synavis::Base64Encode(const uint8_t* Source, std::size_t Length, char* Destination, EBase64Backend Backend)
+{
+  switch (Resolve(Backend))
+  {
+#if SYNAVIS_BASE64_X86
+  case EBase64Backend::AVX2:
+    return EncodeAVX2(Source, Length, Destination);
+  case EBase64Backend::SSSE3:
+    return EncodeSSSE3(Source, Length, Destination);
+#endif
+  default:
+    return EncodeScalar(Source, Length, Destination);
+  }
+}
+
+std::string Synavis::Base64Encode(std::span<const uint8_t> Source, EBase64Backend Backend)
+{
+  std::string result(Base64EncodedLength(Source.size()), '\0');
+  Base64Encode(Source.data(), Source.size(), result.data(), Backend);
+  return result;
+}
+
+bool Synavis::Base64Decode(std::string_view Source, uint8_t* Destination, std::size_t& Written, EBase64Backend Backend)
+{
+  Written = 0;
+  switch (Resolve(Backend))
+  {
+#if SYNAVIS_BASE64_X86
+  case EBase64Backend::AVX2:
+    return DecodeAVX2(Source.data(), Source.size(), Destination, Written);
+  case EBase64Backend::SSSE3:
+    return DecodeSSSE3(Source.data(), Source.size(), Destination, Written);
+#endif
+  default:
+    return DecodeScalar(Source.data(), Source.size(), Destination, Written);
+  }
+}
+
+std::vector<uint8_t> Synavis::Base64Decode(std::string_view Source, EBase64Backend Backend)
+{
+  std::vector<uint8_t> result(Base64DecodedLength(Source.size()));
+  std::size_t written = 0;
+  if (!Base64Decode(Source, result.data(), written, Backend))
+  {
+    throw std::runtime_error("Could not decode base64 string");
+  }
+  result.resize(written);
+  return result;
+}
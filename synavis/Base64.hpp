@@ -0,0 +1,56 @@
+#pragma once
+#ifndef SYNAVIS_BASE64_HPP
+#define SYNAVIS_BASE64_HPP
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // the instruction set that is used for base64 transcoding
+  // Automatic resolves to the widest set that the cpu supports
+  enum class SYNAVIS_EXPORT EBase64Backend
+  {
+    Scalar = 0u,
+    SSSE3,
+    AVX2,
+    Automatic
+  };
+
+  // the backend that the runtime dispatch has selected for this cpu
+  EBase64Backend SYNAVIS_EXPORT Base64Backend();
+  std::string SYNAVIS_EXPORT Base64BackendName(EBase64Backend Backend = EBase64Backend::Automatic);
+
+  // number of characters of the padded encoding of Length bytes
+  constexpr std::size_t Base64EncodedLength(std::size_t Length)
+  {
+    return 4 * ((Length + 2) / 3);
+  }
+
+  // upper bound for the number of bytes that Length characters decode to
+  constexpr std::size_t Base64DecodedLength(std::size_t Length)
+  {
+    return 3 * ((Length + 3) / 4);
+  }
+
+  // encodes Length bytes into Destination, which must hold at least
+  // Base64EncodedLength(Length) characters. Returns the number of characters written.
+  // Backends that are not supported by the cpu fall back to the next narrower one.
+  std::size_t SYNAVIS_EXPORT Base64Encode(const uint8_t* Source, std::size_t Length, char* Destination,
+    EBase64Backend Backend = EBase64Backend::Automatic);
+  std::string SYNAVIS_EXPORT Base64Encode(std::span<const uint8_t> Source,
+    EBase64Backend Backend = EBase64Backend::Automatic);
+
+  // decodes a (padded or unpadded) base64 string into Destination, which must hold at least
+  // Base64DecodedLength(Source.size()) bytes. Returns false if the input is not valid base64.
+  bool SYNAVIS_EXPORT Base64Decode(std::string_view Source, uint8_t* Destination, std::size_t& Written,
+    EBase64Backend Backend = EBase64Backend::Automatic);
+  // throws std::runtime_error if the input is not valid base64
+  std::vector<uint8_t> SYNAVIS_EXPORT Base64Decode(std::string_view Source,
+    EBase64Backend Backend = EBase64Backend::Automatic);
+}
+#endif
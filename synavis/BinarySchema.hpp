@@ -0,0 +1,200 @@
+#pragma once
+#ifndef SYNAVIS_BINARYSCHEMA_HPP
+#define SYNAVIS_BINARYSCHEMA_HPP
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // the byte order of the fields on the wire, independent of the machine
+  enum class SYNAVIS_EXPORT EByteOrder
+  {
+    Little,
+    Big
+  };
+
+  namespace Schema
+  {
+    template < typename T >
+    struct IsStdArray : std::false_type {};
+    template < typename T, std::size_t N >
+    struct IsStdArray<std::array<T, N>> : std::true_type {};
+
+    // numbers, booleans and enums are stored with their own size
+    template < typename T >
+    concept Scalar = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+      && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+    template < typename T >
+    concept FieldType = Scalar<T> || (IsStdArray<T>::value && Scalar<typename T::value_type>);
+
+    template < Scalar T >
+    using Bits = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t,
+      std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+    template < EByteOrder Order, Scalar T >
+    inline void StoreScalar(std::byte* Destination, T Value)
+    {
+      Bits<T> bits;
+      if constexpr (std::is_same_v<T, bool>)
+        bits = Value ? 1u : 0u;
+      else if constexpr (std::is_enum_v<T>)
+        bits = static_cast<Bits<T>>(std::to_underlying(Value));
+      else
+        bits = std::bit_cast<Bits<T>>(Value);
+      if constexpr (sizeof(T) > 1 && (Order == EByteOrder::Little) != (std::endian::native == std::endian::little))
+        bits = std::byteswap(bits);
+      std::memcpy(Destination, &bits, sizeof(bits));
+    }
+
+    template < EByteOrder Order, Scalar T >
+    inline T LoadScalar(const std::byte* Source)
+    {
+      Bits<T> bits;
+      std::memcpy(&bits, Source, sizeof(bits));
+      if constexpr (sizeof(T) > 1 && (Order == EByteOrder::Little) != (std::endian::native == std::endian::little))
+        bits = std::byteswap(bits);
+      // a bool that is not 0 or 1 must not be bit cast
+      if constexpr (std::is_same_v<T, bool>)
+        return bits != 0;
+      else if constexpr (std::is_enum_v<T>)
+        return static_cast<T>(bits);
+      else
+        return std::bit_cast<T>(bits);
+    }
+
+    template < typename T >
+    struct MemberTraits;
+    template < typename C, typename M >
+    struct MemberTraits<M C::*>
+    {
+      using Class = C;
+      using Type = M;
+    };
+  }
+
+  // one field of a schema, named by the member it is read from and written to
+  template < auto Member >
+  struct Field
+  {
+    using Class = typename Schema::MemberTraits<decltype(Member)>::Class;
+    using Type = typename Schema::MemberTraits<decltype(Member)>::Type;
+    static_assert(Schema::FieldType<Type>, "Fields must be numbers, booleans, enums or std::arrays of them with 1, 2, 4 or 8 bytes each");
+    static constexpr std::size_t Size = sizeof(Type);
+
+    template < EByteOrder Order >
+    static void Store(std::byte* Destination, const Class& Source)
+    {
+      if constexpr (Schema::Scalar<Type>)
+      {
+        Schema::StoreScalar<Order>(Destination, Source.*Member);
+      }
+      else
+      {
+        constexpr std::size_t element = sizeof(typename Type::value_type);
+        for (std::size_t i = 0; i < std::tuple_size_v<Type>; ++i)
+          Schema::StoreScalar<Order>(Destination + i * element, (Source.*Member)[i]);
+      }
+    }
+    template < EByteOrder Order >
+    static void Load(const std::byte* Source, Class& Destination)
+    {
+      if constexpr (Schema::Scalar<Type>)
+      {
+        Destination.*Member = Schema::LoadScalar<Order, Type>(Source);
+      }
+      else
+      {
+        constexpr std::size_t element = sizeof(typename Type::value_type);
+        for (std::size_t i = 0; i < std::tuple_size_v<Type>; ++i)
+          (Destination.*Member)[i] = Schema::LoadScalar<Order, typename Type::value_type>(Source + i * element);
+      }
+    }
+  };
+
+  /**
+   * \brief A fixed binary layout for the struct that the fields belong to. The message starts
+   * with the magic and the version, followed by the fields in the order they are listed,
+   * without padding and in the given byte order. A newer version of a message may only append
+   * fields, so a decoder accepts messages of its own and of later versions.
+   *
+   * struct TrackSample { uint32_t Object; double Time; std::array<float, 3> Position; };
+   * using TrackSchema = BinarySchema<0x4B525453u, 1, EByteOrder::Little,
+   *   Field<&TrackSample::Object>, Field<&TrackSample::Time>, Field<&TrackSample::Position>>;
+   * static_assert(TrackSchema::Size == 32);
+   */
+  template < uint32_t inMagic, uint16_t inVersion, EByteOrder Order, typename... Fields >
+  class BinarySchema
+  {
+    static_assert(sizeof...(Fields) > 0, "A schema needs at least one field");
+  public:
+    using Type = typename std::tuple_element_t<0, std::tuple<Fields...>>::Class;
+    static_assert((std::is_same_v<Type, typename Fields::Class> && ...), "All fields must belong to the same struct");
+    static_assert(std::is_default_constructible_v<Type>, "Decoded structs are default constructed");
+
+    static constexpr uint32_t Magic = inMagic;
+    static constexpr uint16_t Version = inVersion;
+    // magic, version and two reserved bytes
+    static constexpr std::size_t HeaderSize = sizeof(uint32_t) + 2 * sizeof(uint16_t);
+    static constexpr std::size_t PayloadSize = (Fields::Size + ...);
+    static constexpr std::size_t Size = HeaderSize + PayloadSize;
+    static_assert(Size <= 65535, "A message must fit into the payload of one Unreal frame");
+
+    // writes Size bytes, Destination must hold at least that many
+    static void Encode(const Type& Value, std::span<std::byte> Destination)
+    {
+      std::byte* position = Destination.data();
+      Schema::StoreScalar<Order>(position, Magic);
+      Schema::StoreScalar<Order>(position + sizeof(uint32_t), Version);
+      Schema::StoreScalar<Order>(position + sizeof(uint32_t) + sizeof(uint16_t), uint16_t{ 0 });
+      position += HeaderSize;
+      ((Fields::template Store<Order>(position, Value), position += Fields::Size), ...);
+    }
+    // like InsertIntoBinary, grows the binary if it ends before Offset + Size
+    template < typename Byte >
+    static std::size_t Encode(const Type& Value, std::vector<Byte>& Binary, std::size_t Offset = 0)
+    {
+      static_assert(sizeof(Byte) == 1, "Binaries are made of bytes");
+      if (Binary.size() < Offset + Size)
+        Binary.resize(Offset + Size);
+      Encode(Value, std::span<std::byte>(reinterpret_cast<std::byte*>(Binary.data()) + Offset, Size));
+      return Offset + Size;
+    }
+
+    // whether Source starts with a message of this schema that a decoder can read
+    static bool Matches(std::span<const std::byte> Source)
+    {
+      return Source.size() >= Size
+        && Schema::LoadScalar<Order, uint32_t>(Source.data()) == Magic
+        && Schema::LoadScalar<Order, uint16_t>(Source.data() + sizeof(uint32_t)) >= Version;
+    }
+    static std::optional<Type> Decode(std::span<const std::byte> Source)
+    {
+      if (!Matches(Source))
+        return std::nullopt;
+      Type value{};
+      const std::byte* position = Source.data() + HeaderSize;
+      ((Fields::template Load<Order>(position, value), position += Fields::Size), ...);
+      return value;
+    }
+    template < typename Byte >
+    static std::optional<Type> Decode(const std::vector<Byte>& Binary, std::size_t Offset = 0)
+    {
+      static_assert(sizeof(Byte) == 1, "Binaries are made of bytes");
+      if (Binary.size() < Offset)
+        return std::nullopt;
+      return Decode(std::span<const std::byte>(reinterpret_cast<const std::byte*>(Binary.data()) + Offset, Binary.size() - Offset));
+    }
+  };
+}
+#endif
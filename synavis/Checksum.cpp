@@ -0,0 +1,119 @@
+#include "Checksum.hpp"
+
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SYNAVIS_CRC_X86 1
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SYNAVIS_CRC_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SYNAVIS_TARGET(x) __attribute__((target(x)))
+#else
+#define SYNAVIS_TARGET(x)
+#endif
+
+namespace
+{
+  // reflected castagnoli polynomial
+  constexpr uint32_t Polynomial = 0x82F63B78u;
+
+  // slicing-by-8 tables, Table[0] is the classic bytewise table
+  constexpr std::array<std::array<uint32_t, 256>, 8> MakeTables()
+  {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit)
+        crc = (crc >> 1) ^ ((crc & 1u) ? Polynomial : 0u);
+      tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+      for (std::size_t t = 1; t < 8; ++t)
+        tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFFu];
+    return tables;
+  }
+  constexpr auto Tables = MakeTables();
+
+  uint32_t Crc32cScalar(const uint8_t* Data, std::size_t Length, uint32_t Crc)
+  {
+    while (Length >= 8)
+    {
+      uint32_t low, high;
+      std::memcpy(&low, Data, sizeof(low));
+      std::memcpy(&high, Data + 4, sizeof(high));
+      low ^= Crc;
+      Crc = Tables[7][low & 0xFF] ^ Tables[6][(low >> 8) & 0xFF] ^ Tables[5][(low >> 16) & 0xFF] ^ Tables[4][low >> 24]
+        ^ Tables[3][high & 0xFF] ^ Tables[2][(high >> 8) & 0xFF] ^ Tables[1][(high >> 16) & 0xFF] ^ Tables[0][high >> 24];
+      Data += 8;
+      Length -= 8;
+    }
+    while (Length-- > 0)
+      Crc = (Crc >> 8) ^ Tables[0][(Crc ^ *Data++) & 0xFF];
+    return Crc;
+  }
+
+#if SYNAVIS_CRC_X86
+  SYNAVIS_TARGET("sse4.2") uint32_t Crc32cSSE42(const uint8_t* Data, std::size_t Length, uint32_t Crc)
+  {
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t crc = Crc;
+    for (; Length >= 8; Data += 8, Length -= 8)
+    {
+      uint64_t word;
+      std::memcpy(&word, Data, sizeof(word));
+      crc = _mm_crc32_u64(crc, word);
+    }
+    Crc = static_cast<uint32_t>(crc);
+#endif
+    for (; Length >= 4; Data += 4, Length -= 4)
+    {
+      uint32_t word;
+      std::memcpy(&word, Data, sizeof(word));
+      Crc = _mm_crc32_u32(Crc, word);
+    }
+    while (Length-- > 0)
+      Crc = _mm_crc32_u8(Crc, *Data++);
+    return Crc;
+  }
+#endif
+
+  bool DetectSSE42()
+  {
+#if SYNAVIS_CRC_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#endif
+#else
+    return false;
+#endif
+  }
+}
+
+bool Synavis::Crc32cAccelerated()
+{
+  static const bool accelerated = DetectSSE42();
+  return accelerated;
+}
+
+uint32_t Synavis::Crc32c(const uint8_t* Data, std::size_t Length, uint32_t Crc)
+{
+  Crc = ~Crc;
+#if SYNAVIS_CRC_X86
+  if (Crc32cAccelerated())
+    return ~Crc32cSSE42(Data, Length, Crc);
+#endif
+  return ~Crc32cScalar(Data, Length, Crc);
+}
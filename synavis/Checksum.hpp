@@ -0,0 +1,21 @@
+#pragma once
+#ifndef SYNAVIS_CHECKSUM_HPP
+#define SYNAVIS_CHECKSUM_HPP
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // crc32c (castagnoli polynomial) of Length bytes, continuing from Crc for data that
+  // is checked in pieces. Uses the sse4.2 crc32 instruction if the cpu supports it
+  uint32_t SYNAVIS_EXPORT Crc32c(const uint8_t* Data, std::size_t Length, uint32_t Crc = 0);
+  inline uint32_t Crc32c(std::span<const uint8_t> Data, uint32_t Crc = 0)
+  {
+    return Crc32c(Data.data(), Data.size(), Crc);
+  }
+  // whether Crc32c runs on the sse4.2 instruction
+  bool SYNAVIS_EXPORT Crc32cAccelerated();
+}
+#endif
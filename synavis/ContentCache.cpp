@@ -0,0 +1,197 @@
+#include "ContentCache.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace
+{
+  constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+  constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+  constexpr uint64_t Prime3 = 0x165667B19E3779F9ull;
+  constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+  constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+  // the hash is defined on little endian words
+  inline uint64_t Read64(const uint8_t* Data)
+  {
+    uint64_t value;
+    std::memcpy(&value, Data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big)
+      value = std::byteswap(value);
+    return value;
+  }
+  inline uint32_t Read32(const uint8_t* Data)
+  {
+    uint32_t value;
+    std::memcpy(&value, Data, sizeof(value));
+    if constexpr (std::endian::native == std::endian::big)
+      value = std::byteswap(value);
+    return value;
+  }
+
+  inline uint64_t Round(uint64_t Accumulator, uint64_t Input)
+  {
+    Accumulator += Input * Prime2;
+    Accumulator = std::rotl(Accumulator, 31);
+    return Accumulator * Prime1;
+  }
+  inline uint64_t MergeRound(uint64_t Accumulator, uint64_t Value)
+  {
+    Accumulator ^= Round(0, Value);
+    return Accumulator * Prime1 + Prime4;
+  }
+}
+
+uint64_t Synavis::ContentHash(std::span<const uint8_t> Data, uint64_t Seed)
+{
+  const uint8_t* position = Data.data();
+  const uint8_t* const end = position + Data.size();
+  uint64_t hash;
+  if (Data.size() >= 32)
+  {
+    // four independent lanes keep the multipliers of the cpu busy
+    uint64_t v1 = Seed + Prime1 + Prime2;
+    uint64_t v2 = Seed + Prime2;
+    uint64_t v3 = Seed;
+    uint64_t v4 = Seed - Prime1;
+    const uint8_t* const limit = end - 32;
+    do
+    {
+      v1 = Round(v1, Read64(position));
+      v2 = Round(v2, Read64(position + 8));
+      v3 = Round(v3, Read64(position + 16));
+      v4 = Round(v4, Read64(position + 24));
+      position += 32;
+    } while (position <= limit);
+    hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+    hash = MergeRound(hash, v1);
+    hash = MergeRound(hash, v2);
+    hash = MergeRound(hash, v3);
+    hash = MergeRound(hash, v4);
+  }
+  else
+  {
+    hash = Seed + Prime5;
+  }
+  hash += static_cast<uint64_t>(Data.size());
+  for (; position + 8 <= end; position += 8)
+  {
+    hash ^= Round(0, Read64(position));
+    hash = std::rotl(hash, 27) * Prime1 + Prime4;
+  }
+  if (position + 4 <= end)
+  {
+    hash ^= static_cast<uint64_t>(Read32(position)) * Prime1;
+    hash = std::rotl(hash, 23) * Prime2 + Prime3;
+    position += 4;
+  }
+  for (; position < end; ++position)
+  {
+    hash ^= static_cast<uint64_t>(*position) * Prime5;
+    hash = std::rotl(hash, 11) * Prime1;
+  }
+  hash ^= hash >> 33;
+  hash *= Prime2;
+  hash ^= hash >> 29;
+  hash *= Prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+std::string Synavis::ContentKey(uint64_t Hash)
+{
+  constexpr char digits[] = "0123456789abcdef";
+  std::string key(16, '0');
+  for (int i = 15; i >= 0; --i, Hash >>= 4)
+    key[i] = digits[Hash & 0xF];
+  return key;
+}
+
+bool Synavis::ContentCache::Touch(uint64_t Hash, std::size_t Size)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto it = Entries.find(Hash);
+  // a different size can only be a collision, the content is sent in full then
+  if (it == Entries.end() || it->second->Size != Size)
+    return false;
+  Order.splice(Order.begin(), Order, it->second);
+  return true;
+}
+
+std::vector<uint64_t> Synavis::ContentCache::Insert(uint64_t Hash, std::size_t Size)
+{
+  std::vector<uint64_t> evicted;
+  std::lock_guard<std::mutex> lock(Mutex);
+  // contents beyond the budget are not worth keeping at the peer
+  if (Size > Budget)
+    return evicted;
+  if (const auto it = Entries.find(Hash); it != Entries.end())
+  {
+    Bytes -= it->second->Size;
+    Order.erase(it->second);
+    Entries.erase(it);
+  }
+  Order.push_front(Entry{ Hash, Size });
+  Entries.emplace(Hash, Order.begin());
+  Bytes += Size;
+  Evict(evicted);
+  return evicted;
+}
+
+void Synavis::ContentCache::Evict(std::vector<uint64_t>& Evicted)
+{
+  while (Bytes > Budget && !Order.empty())
+  {
+    const auto& oldest = Order.back();
+    Evicted.push_back(oldest.Hash);
+    Bytes -= oldest.Size;
+    Entries.erase(oldest.Hash);
+    Order.pop_back();
+  }
+}
+
+void Synavis::ContentCache::Erase(uint64_t Hash)
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto it = Entries.find(Hash);
+  if (it == Entries.end())
+    return;
+  Bytes -= it->second->Size;
+  Order.erase(it->second);
+  Entries.erase(it);
+}
+
+void Synavis::ContentCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  Order.clear();
+  Entries.clear();
+  Bytes = 0;
+}
+
+std::vector<uint64_t> Synavis::ContentCache::SetBudget(std::size_t inBudget)
+{
+  std::vector<uint64_t> evicted;
+  std::lock_guard<std::mutex> lock(Mutex);
+  Budget = inBudget;
+  Evict(evicted);
+  return evicted;
+}
+
+std::size_t Synavis::ContentCache::GetBudget() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Budget;
+}
+
+std::size_t Synavis::ContentCache::GetBytes() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Bytes;
+}
+
+std::size_t Synavis::ContentCache::Size() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Entries.size();
+}
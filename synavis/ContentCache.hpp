@@ -0,0 +1,55 @@
+#pragma once
+#ifndef SYNAVIS_CONTENTCACHE_HPP
+#define SYNAVIS_CONTENTCACHE_HPP
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // 64 bit hash of the content, computed like XXH64 so that other tools can reproduce it
+  uint64_t SYNAVIS_EXPORT ContentHash(std::span<const uint8_t> Data, uint64_t Seed = 0);
+  // the hash as 16 hex digits, json numbers cannot hold 64 bits on every peer
+  std::string SYNAVIS_EXPORT ContentKey(uint64_t Hash);
+
+  // remembers the contents that the peer holds, by hash and size, up to a budget of bytes that
+  // the peer keeps for us. Inserting beyond the budget evicts the least recently used contents,
+  // which the caller has to tell the peer to forget
+  class SYNAVIS_EXPORT ContentCache
+  {
+  public:
+    explicit ContentCache(std::size_t inBudget = 0) : Budget(inBudget) {}
+
+    // whether the peer holds the content, marks it as recently used
+    bool Touch(uint64_t Hash, std::size_t Size);
+    // returns the hashes that were evicted to make room
+    std::vector<uint64_t> Insert(uint64_t Hash, std::size_t Size);
+    void Erase(uint64_t Hash);
+    void Clear();
+    // returns the hashes that were evicted to fit into the new budget
+    std::vector<uint64_t> SetBudget(std::size_t inBudget);
+    std::size_t GetBudget() const;
+    std::size_t GetBytes() const;
+    std::size_t Size() const;
+
+  private:
+    struct Entry
+    {
+      uint64_t Hash;
+      std::size_t Size;
+    };
+    void Evict(std::vector<uint64_t>& Evicted);
+    mutable std::mutex Mutex;
+    std::size_t Budget;
+    std::size_t Bytes{ 0 };
+    // most recently used first
+    std::list<Entry> Order;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> Entries;
+  };
+}
+#endif
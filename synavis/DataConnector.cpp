@@ -1,6 +1,12 @@
 #include "DataConnector.hpp"
+#include "Utf16.hpp"
 #include <rtc/candidate.hpp>
 #include <chrono>
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <ranges>
+#include <numeric>
 #include <codecvt>
 #include <locale>
 #include <bit>
@@ -21,16 +27,72 @@ inline constexpr std::byte operator "" _b(unsigned long long i) noexcept
   return static_cast<std::byte>(i);
 }
 
+// lets the json serializer write straight into an outgoing frame or a reused string
+template < typename Target >
+class AppendingOutputAdapter : public nlohmann::detail::output_adapter_protocol<char>
+{
+public:
+  Target* Destination = nullptr;
+  void write_character(char c) override
+  {
+    if constexpr (std::is_same_v<Target, std::string>)
+      Destination->push_back(c);
+    else
+      Destination->Append(c);
+  }
+  void write_characters(const char* s, std::size_t length) override
+  {
+    if constexpr (std::is_same_v<Target, std::string>)
+      Destination->append(s, length);
+    else
+      Destination->Append(s, length);
+  }
+};
+
+// same output as json::dump() without the intermediate string, the adapter is kept per thread
+template < typename Target >
+static void SerializeJSON(const nlohmann::json& Message, Target& Destination)
+{
+  thread_local auto adapter = std::make_shared<AppendingOutputAdapter<Target>>();
+  adapter->Destination = &Destination;
+  nlohmann::detail::serializer<nlohmann::json> serializer(adapter, ' ', nlohmann::json::error_handler_t::strict);
+  serializer.dump(Message, false, false, 0);
+  adapter->Destination = nullptr;
+}
+
 Synavis::DataConnector::DataConnector()
+  : StripeAssembler([this](rtc::binary Data)
+    {
+      if (DataReceptionCallback.has_value())
+        DataReceptionCallback.value()(std::move(Data));
+    }),
+    FragmentAssembler([this](rtc::binary Data)
+    {
+      // a reassembled message is handled as if it had arrived in one piece
+      DataChannelMessageHandling(std::move(Data));
+    })
 {
+  RegisterFrameHandlers();
 }
 
 Synavis::DataConnector::~DataConnector()
 {
+  // the completions of open requests must not run into a half destroyed connector
+  Requests.FailAll(std::make_exception_ptr(std::runtime_error("The connector was destroyed before the peer answered")));
+  // pending messages go out before the channel closes
+  Batcher.store(nullptr);
   SignallingServer->close();
   PeerConnection->close();
   SubmissionHandler.Stop();
   DataChannel->close();
+  for (auto& channel : StripeChannels)
+  {
+    channel->close();
+  }
+  for (auto& channel : TelemetryChannels)
+  {
+    channel->close();
+  }
 }
 
 void Synavis::DataConnector::StartSignalling()
@@ -38,210 +100,1103 @@ void Synavis::DataConnector::StartSignalling()
   std::string address = "ws://" + config_["SignallingIP"].get<std::string>()
     + ":" + std::to_string(config_["SignallingPort"].get<unsigned>());
   lconnector(ELogVerbosity::Info) << "Starting Signalling to " << address << std::endl;
-  state_ = EConnectionState::STARTUP;
+  SetState(EConnectionState::STARTUP);
   SignallingServer->open(address);
-  while (Block && state_ < EConnectionState::SIGNUP)
+  if (Block && !WaitForState(EConnectionState::SIGNUP, TimeOut))
+  {
+    throw std::runtime_error(Prefix + "Could not reach the signalling server at " + address);
+  }
+}
+
+void Synavis::DataConnector::SetState(EConnectionState State)
+{
+  {
+    std::lock_guard<std::mutex> lock(StateMutex);
+    state_ = State;
+  }
+  StateCondition.notify_all();
+  // senders that wait for the buffer to drain must not wait for a closed channel
+  {
+    std::lock_guard<std::mutex> lock(BufferMutex);
+  }
+  BufferCondition.notify_all();
+  // no answer can arrive anymore
+  if (State == EConnectionState::CLOSED || State == EConnectionState::RTCERROR)
+  {
+    Requests.FailAll(std::make_exception_ptr(std::runtime_error("The connection was closed before the peer answered")));
+    // what the peer kept belongs to this connection
+    Contents.Clear();
+    ContentsSynchronized = false;
+  }
+}
+
+bool Synavis::DataConnector::WaitForState(EConnectionState State, double TimeOutSeconds)
+{
+  std::optional<WaitMetric::clock::time_point> deadline;
+  if (TimeOutSeconds > 0.0)
+  {
+    deadline = WaitMetric::clock::now() + std::chrono::duration_cast<WaitMetric::clock::duration>(std::chrono::duration<double>(TimeOutSeconds));
+  }
+  std::unique_lock<std::mutex> lock(StateMutex);
+  return Waits.Wait(StateCondition, lock, deadline, [this, State]() { return state_ >= State; });
+}
+
+bool Synavis::DataConnector::Transmit(const rtc::binary& Frame, ESendPriority Priority)
+{
+  return Transmit(*DataChannel, Frame, Priority);
+}
+
+bool Synavis::DataConnector::Transmit(rtc::DataChannel& Channel, const rtc::binary& Frame, ESendPriority Priority)
+{
+  using clock = WaitMetric::clock;
+  const auto queued = clock::now();
+  const auto lane = static_cast<std::size_t>(Priority);
+  // a control frame counts as queued from here until the transport has taken it, including
+  // the time it spends in pacing and in front of the high-water mark
+  const bool holds_control = (Priority == ESendPriority::Control && BulkBufferLimit > 0);
+  if (holds_control)
+  {
+    std::lock_guard<std::mutex> lock(BufferMutex);
+    ControlQueued++;
+  }
+  else if (BulkBufferLimit > 0)
+  {
+    // bulk frames only enter the transport while no control frame is queued and while the
+    // transport holds little data, so that a control frame never queues behind a large backlog
+    std::unique_lock<std::mutex> lock(BufferMutex);
+    const auto deadline = queued + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(TimeOut));
+    BufferCondition.wait_until(lock, deadline, [this, &Channel]()
+      {
+        return (ControlQueued == 0 && Channel.bufferedAmount() <= BulkBufferLimit)
+          || state_ != EConnectionState::CONNECTED;
+      });
+  }
+  const auto release_control = [this, holds_control]()
+    {
+      if (!holds_control)
+        return;
+      // bulk senders that stepped aside for this frame may continue
+      {
+        std::lock_guard<std::mutex> lock(BufferMutex);
+        ControlQueued--;
+      }
+      BufferCondition.notify_all();
+    };
+  try
+  {
+    if (PacingRate > 0.0)
+    {
+      // token bucket that may go into debt, a frame larger than the burst size is sent
+      // right away and the following frames wait until the debt is paid off. Control frames
+      // take their tokens without waiting, the bulk frames behind them pay the debt
+      clock::duration delay{ 0 };
+      {
+        std::lock_guard<std::mutex> lock(PacingMutex);
+        const auto now = clock::now();
+        PacingTokens = std::min(static_cast<double>(PacingBurst),
+          PacingTokens + PacingRate * std::chrono::duration<double>(now - PacingRefill).count());
+        PacingRefill = now;
+        PacingTokens -= static_cast<double>(Frame.size());
+        if (PacingTokens < 0.0 && Priority == ESendPriority::Bulk)
+          delay = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(-PacingTokens / PacingRate));
+      }
+      if (delay > clock::duration::zero())
+      {
+        std::this_thread::sleep_for(delay);
+        Waits.Add(delay);
+      }
+    }
+    if (SendHighWaterMark > 0 && Channel.bufferedAmount() > 0
+      && Channel.bufferedAmount() + Frame.size() > SendHighWaterMark)
+    {
+      // suspend until the transport has drained down to the low mark, see onBufferedAmountLow
+      lconnector(ELogVerbosity::Verbose) << "Send buffer holds " << Channel.bufferedAmount() << " bytes, waiting for it to drain" << std::endl;
+      const auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(TimeOut));
+      std::unique_lock<std::mutex> lock(BufferMutex);
+      if (!Waits.Wait(BufferCondition, lock, deadline, [this, &Channel]()
+        { return Channel.bufferedAmount() <= SendHighWaterMark / 2 || state_ != EConnectionState::CONNECTED; }))
+      {
+        lconnector(ELogVerbosity::Warning) << "Send buffer did not drain within " << TimeOut << " seconds, sending anyway" << std::endl;
+      }
+    }
+    LaneLatency[lane].Add(clock::now() - queued);
+    const bool sent = Channel.sendBuffer(Frame);
+    release_control();
+    return sent;
+  }
+  catch (...)
+  {
+    release_control();
+    throw;
+  }
+}
+
+void Synavis::DataConnector::SetBulkBufferLimit(std::size_t Bytes)
+{
+  BulkBufferLimit = Bytes;
+  SetSendHighWaterMark(SendHighWaterMark);
+}
+
+void Synavis::DataConnector::SetSendHighWaterMark(std::size_t Bytes)
+{
+  SendHighWaterMark = Bytes;
+  if (DataChannel)
+  {
+    DataChannel->setBufferedAmountLowThreshold(GetBufferedAmountLowThreshold());
+  }
+  std::lock_guard<std::mutex> lock(StripeMutex);
+  for (auto& channel : StripeChannels)
   {
-    std::this_thread::yield();
+    channel->setBufferedAmountLowThreshold(GetBufferedAmountLowThreshold());
   }
 }
 
+void Synavis::DataConnector::SetPacing(double BytesPerSecond, std::size_t BurstBytes)
+{
+  std::lock_guard<std::mutex> lock(PacingMutex);
+  PacingRate = BytesPerSecond;
+  PacingBurst = (BurstBytes > 0) ? BurstBytes : static_cast<std::size_t>(BytesPerSecond / 10.0);
+  PacingTokens = static_cast<double>(PacingBurst);
+  PacingRefill = WaitMetric::clock::now();
+}
+
 void Synavis::DataConnector::SendData(rtc::binary Data)
 {
   if (this->state_ != EConnectionState::CONNECTED)
     return;
-  if (Data.size() > this->MaxMessageSize)
+  FlushBatch();
+  // a peer that takes extended frames is not bound to the size of the Unreal frame
+  const std::size_t max_message = UsesExtendedFrames() ? DataChannel->maxMessageSize() : this->MaxMessageSize;
+  if (Data.size() > max_message)
+  {
+    lconnector(ELogVerbosity::Debug) << "Fragmenting message of size " << Data.size() << std::endl;
+    TransmitFragments(Data, max_message, [this]() -> rtc::DataChannel& { return *DataChannel; });
+  }
+  else
+  {
+    Transmit(Data);
+  }
+}
+
+bool Synavis::DataConnector::TransmitFragments(std::span<const std::byte> Message, std::size_t MaxFrameSize,
+  const std::function<rtc::DataChannel&()>& SelectChannel)
+{
+  const std::size_t piece_size = MaxFrameSize - sizeof(FragmentHeader);
+  const std::size_t pieces = std::max((Message.size() + piece_size - 1) / piece_size, static_cast<std::size_t>(1));
+  if (pieces > std::numeric_limits<uint32_t>::max() || piece_size > std::numeric_limits<uint32_t>::max())
   {
-    rtc::binary Chunk(this->MaxMessageSize);
-    const auto meta_size = sizeof(int) + sizeof(int) + sizeof(uint16_t) + sizeof(std::byte);
-    unsigned int chunks{ 1 };
-    for (; (meta_size * chunks + Data.size()) / chunks < this->MaxMessageSize; ++chunks);
+    throw std::runtime_error(Prefix + "Message of size " + std::to_string(Message.size()) + " cannot be fragmented");
+  }
+  FragmentHeader header{};
+  header.MessageId = NextFragmentId++;
+  header.Count = static_cast<uint32_t>(pieces);
+  header.PieceSize = static_cast<uint32_t>(piece_size);
+  header.Total = Message.size();
+  rtc::binary frame(sizeof(FragmentHeader) + piece_size);
+  bool sent = true;
+  for (std::size_t i = 0; i < pieces && sent; ++i)
+  {
+    const auto length = std::min(piece_size, Message.size() - i * piece_size);
+    header.Sequence = static_cast<uint32_t>(i);
+    frame.resize(sizeof(FragmentHeader) + length);
+    memcpy(frame.data(), &header, sizeof(header));
+    memcpy(frame.data() + sizeof(header), Message.data() + i * piece_size, length);
+    sent = Transmit(SelectChannel(), frame, ESendPriority::Bulk);
+  }
+  return sent;
+}
 
-    // iterate through the chunks
-    for (auto i = 0u; i < chunks; ++i)
+bool Synavis::DataConnector::InsertFragment(MessageAssembler& Assembler, const rtc::binary& Data)
+{
+  FragmentHeader header;
+  if (Data.size() < sizeof(header))
+    return false;
+  memcpy(&header, Data.data(), sizeof(header));
+  if (header.Magic != FragmentHeader::ExpectedMagic)
+    return false;
+  // the fragment is dropped on anything that goes wrong, a broken peer must not take the receiving thread down
+  try
+  {
+    if (!Assembler.Insert(header.MessageId, header.Sequence, header.Count, header.PieceSize, header.Total,
+      std::span<const std::byte>(Data).subspan(sizeof(header))))
     {
-      std::size_t n = 0u;
-      n = InsertIntoBinary(Chunk, n, std::byte(50), uint16_t(0));
-      n = InsertIntoBinary(Chunk, n, i, chunks);
-      memcpy(Chunk.data() + n, Data.data() + i * chunks, this->MaxMessageSize - meta_size);
-      DataChannel->sendBuffer(Chunk);
+      lconnector(ELogVerbosity::Warning) << "Dropping invalid fragment " << header.Sequence << " of " << header.Count
+        << " of message " << header.MessageId << " with " << header.Total << " bytes" << std::endl;
     }
   }
-  else
+  catch (const std::exception& e)
   {
-    DataChannel->sendBuffer(Data);
+    lconnector(ELogVerbosity::Error) << "Dropping fragment " << header.Sequence << " of message " << header.MessageId
+      << ": " << e.what() << std::endl;
   }
+  return true;
+}
+
+void Synavis::DataConnector::SetFragmentTimeout(double Seconds)
+{
+  const auto timeout = std::chrono::duration_cast<MessageAssembler::clock::duration>(std::chrono::duration<double>(Seconds));
+  StripeAssembler.SetStaleTimeout(timeout);
+  FragmentAssembler.SetStaleTimeout(timeout);
+}
+
+void Synavis::DataConnector::SetFragmentLimit(uint64_t Bytes)
+{
+  StripeAssembler.SetMaxTotal(Bytes);
+  FragmentAssembler.SetMaxTotal(Bytes);
+}
+
+void Synavis::DataConnector::SetFragmentBudget(uint64_t Bytes)
+{
+  StripeAssembler.SetMaxPendingBytes(Bytes);
+  FragmentAssembler.SetMaxPendingBytes(Bytes);
 }
 
 void Synavis::DataConnector::SendString(std::string Message)
 {
   if (this->state_ != EConnectionState::CONNECTED)
     return;
+  FlushBatch();
   json content = { {"origin","dataconnector"},{"data",Message} };
   std::string json_message = content.dump();
   // prepare bytes that Unreal expects at the beginning of the message
-  // rtc::binary bytes(3 + 2 * json_message.length());
-  rtc::binary bytes(4 + json_message.length());
-  bytes[bytes.size() - 1] = std::byte(0); // null terminator
-  bytes.at(0) = DataChannelByte;
-  uint16_t* buffer = reinterpret_cast<uint16_t*>(&(bytes.at(1)));
-  *buffer = static_cast<uint16_t>(json_message.size());
-  for (int i = 0; i < json_message.size(); i++)
-  {
-    //bytes.at(3 + 2 * i) = static_cast<std::byte>(json_message.at(i));
-    //bytes.at(3 + 2 * i + 1) = 0_b;
-    bytes.at(3 + i) = static_cast<std::byte>(json_message.at(i));
-  }
-  DataChannel->sendBuffer(bytes);
+  auto frame = AcquireFrame(json_message.size());
+  memcpy(frame.PayloadData(), json_message.data(), json_message.size());
+  SendFrame(std::move(frame));
 }
 
-void Synavis::DataConnector::SendJSON(json Message)
+void Synavis::DataConnector::SendJSON(const json& Message)
 {
   if (this->state_ != EConnectionState::CONNECTED)
     return;
-  std::string json_message = Message.dump();
-  // prepare bytes that Unreal expects at the beginning of the message
-  rtc::binary bytes(4 + json_message.length());
-  bytes[bytes.size() - 1] = std::byte(0);
-  bytes.at(0) = DataChannelByte;
-  uint16_t* buffer = reinterpret_cast<uint16_t*>(&(bytes.at(1)));
-  *buffer = static_cast<uint16_t>(json_message.size());
+  if (TransmitTelemetry(Message))
+    return;
+  if (const auto batcher = Batcher.load())
+  {
+    thread_local std::string json_message;
+    json_message.clear();
+    SerializeJSON(Message, json_message);
+    if (lconnector.IsEnabled(ELogVerbosity::Info))
+      lconnector(ELogVerbosity::Info) << "Batching JSON: " << json_message << std::endl;
+    batcher->Add(json_message);
+    return;
+  }
+  // the text is written behind the header that Unreal expects at the beginning of the message
+  auto frame = AcquireFrame(0);
+  frame.BeginAppend();
+  SerializeJSON(Message, frame);
+  frame.EndAppend();
+  if (lconnector.IsEnabled(ELogVerbosity::Info))
+  {
+    std::string temp = std::string((char*)frame.Data().data(), frame.Data().size());
+    lconnector(ELogVerbosity::Info) << "Sending JSON: " << temp << std::endl;
+  }
+  SendFrame(std::move(frame));
+}
 
-  // copy the json string into the buffer
-  memcpy(bytes.data() + 3, json_message.data(), json_message.size());
+Synavis::PooledFrame Synavis::DataConnector::AcquireFrame(std::size_t PayloadSize)
+{
+  if (UsesExtendedFrames())
+  {
+    return Frames.Acquire(ExtendedDataChannelByte, PayloadSize, true);
+  }
+  return Frames.Acquire(DataChannelByte, PayloadSize);
+}
 
-  std::string temp = std::string((char*)bytes.data(), bytes.size());
-  lconnector(ELogVerbosity::Info) << "Sending JSON: " << temp << std::endl;
-  DataChannel->sendBuffer(bytes);
+std::size_t Synavis::DataConnector::GetMaxFramePayload() const
+{
+  if (UsesExtendedFrames())
+  {
+    return std::min(DataChannel->maxMessageSize(), static_cast<std::size_t>(std::numeric_limits<uint32_t>::max())) - PooledFrame::ExtendedOverhead;
+  }
+  return this->MaxMessageSize - PooledFrame::Overhead;
 }
 
-bool Synavis::DataConnector::SendBuffer(const std::span<const uint8_t>& Buffer, std::string Name, std::string Format)
+void Synavis::DataConnector::SetCoalescing(bool Enable, double DeadlineSeconds)
 {
-  // this method briefly exchanges the callback for message reception
-  auto msg_callback = MessageReceptionCallback;
-  int MessageState = (this->DontWaitForAnswer) ? 1 : 0;
-  int StateTracker = 1;
-  this->SetMessageCallback([&msg_callback, &MessageState, this](std::string Message)
-    {
-      lconnector(ELogVerbosity::Info) << "Message received: " << Message << std::endl;
-      json content = json::parse(Message);
-      if (content["type"] == "buffer")
-      {
-        MessageState = MessageState + 1;
-      }
-      else if (content["type"] == "error")
-      {
-        MessageState = -1;
-      }
-      else if (msg_callback.has_value())
-      {
-        msg_callback.value()(Message);
-      }
-    });
-  auto WaitTimeout = [&MessageState, &StateTracker, this](bool bFail = true, double failtime = 2.0)
+  if (!Enable)
   {
-    auto start_time = std::chrono::system_clock::now();
-    auto failtime_seconds = std::chrono::duration<double>(failtime);
-    auto waittime = failtime_seconds / 10.0;
-    while (MessageState < StateTracker)
+    Batcher.store(nullptr);
+    return;
+  }
+  const auto deadline = std::chrono::duration_cast<MessageBatcher::clock::duration>(std::chrono::duration<double>(DeadlineSeconds));
+  const auto max_payload = std::min(this->MaxMessageSize, static_cast<std::size_t>(std::numeric_limits<uint16_t>::max() - 3)) - 4;
+  // a sender that still holds the previous batcher finishes with it, its messages are flushed once it is released
+  Batcher.store(std::make_shared<MessageBatcher>([this](std::string_view Payload)
     {
-      if (this->LogVerbosity >= ELogVerbosity::Verbose)
-      {
-        std::this_thread::sleep_for(waittime);
-        lconnector(ELogVerbosity::Verbose) << "Waiting for message " << StateTracker << " time " << std::chrono::duration<double>(std::chrono::system_clock::now() - start_time).count() << " of " << failtime_seconds.count() << "." << std::endl;
-      }
-      else
-      {
-        std::this_thread::yield();
-      }
-      if (bFail && (std::chrono::duration<double>(std::chrono::system_clock::now() - start_time) > failtime_seconds))
-      {
-        lconnector(ELogVerbosity::Debug) << "Message reception timed out" << std::endl;
-        MessageState = -1;
-        break;
-      }
-    }
-    StateTracker++;
-  };
+      auto frame = AcquireFrame(Payload.size());
+      memcpy(frame.PayloadData(), Payload.data(), Payload.size());
+      Transmit(frame.Data());
+    }, max_payload, deadline));
+}
+
+void Synavis::DataConnector::FlushBatch()
+{
+  if (const auto batcher = Batcher.load())
+  {
+    batcher->Flush();
+  }
+}
+
+bool Synavis::DataConnector::SendFrame(PooledFrame Frame)
+{
+  if (this->state_ != EConnectionState::CONNECTED || !Frame.IsValid())
+    return false;
+  FlushBatch();
+  // the frame goes back to the pool when it leaves this scope
+  return Transmit(Frame.Data());
+}
+
+bool Synavis::DataConnector::SendBuffer(const std::span<const uint8_t>& Buffer, std::string Name, std::string Format)
+{
+  return SendDeduplicated(Buffer, Name, Format, [&]() { return TransmitBuffer(Buffer, Name, Format); });
+}
+
+bool Synavis::DataConnector::TransmitBuffer(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Format)
+{
   std::size_t chunk_size{}, chunks{}, total_size{};
-  const uint8_t* Source = nullptr;
-  bool NeedToDelete = false;
+  // peers that check the chunks get a checksum header in front of every chunk
+  const bool resumable = ResumableTransfers && !DontWaitForAnswer && PeerSupports("resumable");
+  const std::size_t frame_payload = GetMaxFramePayload() - (resumable ? sizeof(CheckedChunkHeader) : 0);
+  // writes the payload of chunk i into the frame and returns its length
+  std::function<std::size_t(std::size_t, uint8_t*)> WriteChunk;
   if (Format == "raw")
   {
     total_size = Buffer.size();
-    chunk_size = this->MaxMessageSize - 4;
-    chunks = std::max(Buffer.size() / chunk_size, static_cast<std::size_t>(1));
-    Source = reinterpret_cast<const uint8_t*>(Buffer.data());
+    chunk_size = frame_payload;
+    chunks = std::max((total_size + chunk_size - 1) / chunk_size, static_cast<std::size_t>(1));
+    WriteChunk = [&Buffer, chunk_size](std::size_t i, uint8_t* Target)
+    {
+      const auto length = std::min(chunk_size, Buffer.size() - i * chunk_size);
+      memcpy(Target, Buffer.data() + i * chunk_size, length);
+      return length;
+    };
   }
   else if (Format == "base64")
   {
+    // the chunks are encoded one at a time directly into the frame. Every chunk but the last
+    // covers a multiple of three bytes, so the concatenated chunks form one valid encoding
     total_size = EncodedSize(Buffer);
-    chunk_size = this->MaxMessageSize - 4;
-    chunks = total_size / chunk_size + 1;
-    const auto ConvertedDat = Encode64(Buffer);
-    const std::string DebugTest(ConvertedDat.begin(), ConvertedDat.end());
-    Source = reinterpret_cast<const uint8_t*>(ConvertedDat.data());
-    NeedToDelete = true;
+    chunk_size = (frame_payload / 4) * 4;
+    const std::size_t source_chunk = (chunk_size / 4) * 3;
+    chunks = std::max((Buffer.size() + source_chunk - 1) / source_chunk, static_cast<std::size_t>(1));
+    WriteChunk = [&Buffer, source_chunk](std::size_t i, uint8_t* Target)
+    {
+      const auto length = std::min(source_chunk, Buffer.size() - i * source_chunk);
+      return Base64Encode(Buffer.data() + i * source_chunk, length, reinterpret_cast<char*>(Target));
+    };
   }
   else if (Format == "ascii")
   {
 
   }
-  if (!Source)
+  if (!WriteChunk)
   {
-    if (NeedToDelete)
+    throw std::runtime_error(Prefix + "Invalid format for buffer transmission");
+  }
+  lconnector(ELogVerbosity::Debug) << "Transmitting buffer of size " << Buffer.size() << " in " << chunks << " chunks of size " << chunk_size << std::endl;
+  // the chunks carry no header, so the peer can only tell them apart if one such buffer is sent at a time
+  std::lock_guard<std::mutex> lock(BufferTransferMutex);
+  json start{ {"type","buffer"}, {"start",Name }, {"size", total_size}, {"format", Format} };
+  json stop{ {"type","buffer"},{"stop",Name} };
+  if (resumable)
+  {
+    return this->TransmitResumable(chunks, chunk_size, WriteChunk, std::move(start), std::move(stop));
+  }
+  return this->TransmitChunks(chunks, chunk_size, WriteChunk, std::move(start), std::move(stop));
+}
+
+bool Synavis::DataConnector::SendBinaryArray(std::span<const uint8_t> Buffer, std::string Name, EBinaryElementType Type)
+{
+  const std::string kind = "binary" + std::to_string(static_cast<unsigned>(Type));
+  return SendDeduplicated(Buffer, Name, kind, [&]() { return TransmitBinaryArray(Buffer, Name, Type); });
+}
+
+bool Synavis::DataConnector::TransmitBinaryArray(std::span<const uint8_t> Buffer, const std::string& Name, EBinaryElementType Type)
+{
+  if (Name.size() >= sizeof(BinaryGeometryHeader::Name))
+  {
+    throw std::runtime_error(Prefix + "Array name " + Name + " is too long for binary transmission");
+  }
+  const std::size_t element_size = BinaryElementSize(Type);
+  // each frame carries the header and a whole number of elements
+  const std::size_t chunk_size = ((GetMaxFramePayload() - sizeof(BinaryGeometryHeader)) / element_size) * element_size;
+  const std::size_t elements = Buffer.size() / element_size;
+  const std::size_t chunks = std::max((Buffer.size() + chunk_size - 1) / chunk_size, static_cast<std::size_t>(1));
+  BinaryGeometryHeader header{};
+  memcpy(header.Name, Name.data(), Name.size());
+  header.ElementType = static_cast<uint8_t>(Type);
+  header.Total = elements;
+  // every frame names its transfer, so binary arrays can be sent concurrently
+  auto transfer = OpenTransfer();
+  header.TransferId = transfer->Id;
+  auto WriteChunk = [&Buffer, &header, chunk_size, element_size](std::size_t i, uint8_t* Target)
+  {
+    const auto length = std::min(chunk_size, Buffer.size() - i * chunk_size);
+    header.Offset = (i * chunk_size) / element_size;
+    header.Count = static_cast<uint32_t>(length / element_size);
+    memcpy(Target, &header, sizeof(header));
+    memcpy(Target + sizeof(header), Buffer.data() + i * chunk_size, length);
+    return sizeof(header) + length;
+  };
+  lconnector(ELogVerbosity::Debug) << "Transmitting binary array " << Name << " of " << elements << " elements in " << chunks << " chunks" << std::endl;
+  return this->TransmitChunks(chunks, chunk_size + sizeof(BinaryGeometryHeader), WriteChunk, std::nullopt, std::nullopt, transfer);
+}
+
+void Synavis::DataConnector::SetDeduplication(bool Enable, std::size_t BudgetBytes)
+{
+  Deduplication = Enable;
+  for (const auto hash : Contents.SetBudget(Enable ? BudgetBytes : 0))
+    this->SendJSON({ {"type","buffer"},{"forget",ContentKey(hash)} });
+}
+
+void Synavis::DataConnector::InvalidateContents()
+{
+  Contents.Clear();
+  this->SendJSON({ {"type","buffer"},{"forget","all"} });
+  ContentsSynchronized = true;
+}
+
+bool Synavis::DataConnector::SendDeduplicated(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Kind, const std::function<bool(void)>& Upload,
+  std::vector<DeferredReference>* Deferred)
+{
+  // the peer has to answer the references, and small arrays are not worth a round trip
+  if (!Deduplication || DontWaitForAnswer || Buffer.size() < 1024 || !PeerSupports("dedup"))
+    return Upload();
+  if (!ContentsSynchronized.exchange(true))
+    this->SendJSON({ {"type","buffer"},{"forget","all"} });
+  // the peer places a content by name and representation, so both seed the hash. The same
+  // bytes sent as another array or in another format get a key of their own
+  std::string seed_text = Name;
+  seed_text.push_back('\0');
+  seed_text.append(Kind);
+  const uint64_t seed = ContentHash(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(seed_text.data()), seed_text.size()));
+  const uint64_t hash = ContentHash(Buffer, seed);
+  if (Contents.Touch(hash, Buffer.size()))
+  {
+    auto answer = Request({ {"type","buffer"},{"reference",ContentKey(hash)},{"name",Name},{"kind",Kind},{"size",Buffer.size()} });
+    if (Deferred != nullptr)
     {
-      delete[] Source;
+      Deferred->push_back(DeferredReference{ std::move(answer), Buffer, Name, Kind, hash, Upload });
+      return true;
     }
-    throw std::runtime_error(Prefix + "Invalid format for buffer transmission");
+    if (AwaitReference(answer, hash, Buffer.size(), Name))
+      return true;
+  }
+  return UploadAndKeep(Buffer, Name, Kind, hash, Upload);
+}
+
+bool Synavis::DataConnector::AwaitReference(std::future<json>& Answer, uint64_t Hash, std::size_t Size, const std::string& Name)
+{
+  try
+  {
+    Answer.get();
+    DeduplicatedBytes += Size;
+    lconnector(ELogVerbosity::Debug) << "Sent " << Name << " as reference to " << ContentKey(Hash) << std::endl;
+    return true;
+  }
+  catch (const std::exception& e)
+  {
+    // the peer lost the content, it is sent in full and kept again
+    lconnector(ELogVerbosity::Info) << "Peer could not resolve " << ContentKey(Hash) << ": " << e.what() << std::endl;
+    Contents.Erase(Hash);
+    return false;
+  }
+}
+
+bool Synavis::DataConnector::UploadAndKeep(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Kind, uint64_t Hash, const std::function<bool(void)>& Upload)
+{
+  if (!Upload())
+    return false;
+  if (Buffer.size() > Contents.GetBudget())
+    return true;
+  // the peer keeps what it just received under the hash. Its answer is not awaited, a content
+  // that it could not keep fails the next reference and is sent in full then
+  for (const auto evicted : Contents.Insert(Hash, Buffer.size()))
+    this->SendJSON({ {"type","buffer"},{"forget",ContentKey(evicted)} });
+  SendRequest({ {"type","buffer"},{"store",ContentKey(Hash)},{"name",Name},{"kind",Kind} }, [this, Hash](json, std::exception_ptr Error)
+    {
+      if (Error)
+        Contents.Erase(Hash);
+    });
+  return true;
+}
+
+bool Synavis::DataConnector::ResolveReferences(std::vector<DeferredReference>& Deferred)
+{
+  bool state = true;
+  // the answers arrived while the other arrays were sent, so this waits for about one round trip in total
+  for (auto& reference : Deferred)
+  {
+    if (AwaitReference(reference.Answer, reference.Hash, reference.Buffer.size(), reference.Name))
+      continue;
+    bool uploaded = false;
+    do
+    {
+      uploaded = UploadAndKeep(reference.Buffer, reference.Name, reference.Kind, reference.Hash, reference.Upload);
+    } while (!uploaded && RetryOnErrorResponse);
+    state = state && uploaded;
+  }
+  Deferred.clear();
+  return state;
+}
+
+std::size_t Synavis::DataConnector::GetOpenStripeChannels()
+{
+  std::lock_guard<std::mutex> lock(StripeMutex);
+  return std::ranges::count_if(StripeChannels, [](const auto& Channel) { return Channel->isOpen(); });
+}
+
+bool Synavis::DataConnector::SendStriped(std::span<const uint8_t> Buffer)
+{
+  if (this->state_ != EConnectionState::CONNECTED)
+    return false;
+  std::vector<std::shared_ptr<rtc::DataChannel>> channels;
+  {
+    std::lock_guard<std::mutex> lock(StripeMutex);
+    std::ranges::copy_if(StripeChannels, std::back_inserter(channels), [](const auto& Channel) { return Channel->isOpen(); });
+  }
+  if (channels.empty())
+  {
+    lconnector(ELogVerbosity::Warning) << "There is no open stripe channel, call SetStripeChannels before Initialize" << std::endl;
+    return false;
+  }
+  // the stripes do not carry the Unreal framing, so a piece may use the full message size of every channel
+  std::size_t max_message = std::ranges::min(channels | std::views::transform([](const auto& Channel) { return Channel->maxMessageSize(); }));
+  max_message = std::min(max_message, static_cast<std::size_t>(std::numeric_limits<uint32_t>::max()));
+  lconnector(ELogVerbosity::Debug) << "Striping buffer of size " << Buffer.size() << " over " << channels.size() << " channels" << std::endl;
+  FlushBatch();
+  // the channel with the least queued data goes next, so that a stalled stream does not hold up the others
+  return TransmitFragments(std::as_bytes(Buffer), max_message, [&channels]() -> rtc::DataChannel&
+    {
+      return **std::ranges::min_element(channels, {}, [](const auto& Channel) { return Channel->bufferedAmount(); });
+    });
+}
+
+void Synavis::DataConnector::AddStripeChannel(std::shared_ptr<rtc::DataChannel> Channel)
+{
+  Channel->onMessage(std::bind(&DataConnector::StripeMessageHandling, this, std::placeholders::_1));
+  Channel->onError([this](std::string error)
+    {
+      lconnector(ELogVerbosity::Error) << "Stripe channel error: " << error << std::endl;
+    });
+  Channel->setBufferedAmountLowThreshold(GetBufferedAmountLowThreshold());
+  Channel->onBufferedAmountLow([this]()
+    {
+      {
+        std::lock_guard<std::mutex> lock(BufferMutex);
+      }
+      BufferCondition.notify_all();
+    });
+  std::lock_guard<std::mutex> lock(StripeMutex);
+  StripeChannels.push_back(std::move(Channel));
+}
+
+void Synavis::DataConnector::StripeMessageHandling(rtc::message_variant Data)
+{
+  if (!std::holds_alternative<rtc::binary>(Data))
+  {
+    lconnector(ELogVerbosity::Warning) << "Received a text message on a stripe channel" << std::endl;
+    return;
+  }
+  if (!InsertFragment(StripeAssembler, std::get<rtc::binary>(Data)))
+  {
+    lconnector(ELogVerbosity::Warning) << "Received a stripe piece without fragment header" << std::endl;
+  }
+}
+
+void Synavis::DataConnector::SetTelemetryChannel(bool Enable, unsigned LifetimeMilliseconds)
+{
+  TelemetryChannel = Enable;
+  TelemetryLifetime = LifetimeMilliseconds;
+}
+
+bool Synavis::DataConnector::HasTelemetryChannel()
+{
+  std::lock_guard<std::mutex> lock(TelemetryMutex);
+  return std::ranges::any_of(TelemetryChannels, [](const auto& Channel) { return Channel->isOpen(); });
+}
+
+void Synavis::DataConnector::AddTelemetryChannel(std::shared_ptr<rtc::DataChannel> Channel)
+{
+  // the frames are the same as on the main channel, only their delivery is not guaranteed
+  Channel->onMessage(std::bind(&DataConnector::DataChannelMessageHandling, this, std::placeholders::_1));
+  Channel->onError([this](std::string error)
+    {
+      lconnector(ELogVerbosity::Error) << "Telemetry channel error: " << error << std::endl;
+    });
+  std::lock_guard<std::mutex> lock(TelemetryMutex);
+  TelemetryChannels.push_back(std::move(Channel));
+}
+
+bool Synavis::DataConnector::TransmitTelemetry(const json& Message)
+{
+  if (!Message.contains("type") || !Message["type"].is_string()
+    || std::ranges::find(TelemetryTypes, Message["type"].get_ref<const std::string&>()) == TelemetryTypes.end())
+    return false;
+  std::shared_ptr<rtc::DataChannel> channel;
+  {
+    std::lock_guard<std::mutex> lock(TelemetryMutex);
+    auto open = std::ranges::find_if(TelemetryChannels, [](const auto& Channel) { return Channel->isOpen(); });
+    if (open == TelemetryChannels.end())
+      return false;
+    channel = *open;
   }
+  auto frame = AcquireFrame(0);
+  frame.BeginAppend();
+  SerializeJSON(Message, frame);
+  frame.EndAppend();
+  // a sample that does not fit into one message is not split up, a lost piece would void all of it
+  if (frame.Data().size() > channel->maxMessageSize())
+    return false;
+  // the sample bypasses the batch and the lanes, it must not wait for anything
+  if (channel->bufferedAmount() > TelemetryBufferLimit)
+  {
+    DroppedTelemetry++;
+    lconnector(ELogVerbosity::Verbose) << "Telemetry channel is congested, dropping the sample" << std::endl;
+    return true;
+  }
+  channel->sendBuffer(frame.Data());
+  return true;
+}
+
+std::shared_ptr<Synavis::DataConnector::Transfer> Synavis::DataConnector::OpenTransfer()
+{
+  auto transfer = std::make_shared<Transfer>();
+  std::lock_guard<std::mutex> lock(TransferMutex);
+  // 0 means no transfer on the wire, and an id is not handed out twice while it is in use
+  do
+  {
+    transfer->Id = NextTransferId++;
+  } while (transfer->Id == 0 || Transfers.contains(transfer->Id));
+  Transfers.emplace(transfer->Id, transfer);
+  return transfer;
+}
+
+void Synavis::DataConnector::CloseTransfer(const std::shared_ptr<Transfer>& Current)
+{
+  {
+    std::lock_guard<std::mutex> lock(TransferMutex);
+    Transfers.erase(Current->Id);
+  }
+  // a dispatcher that still holds the transfer must not call into the finished transmission
+  std::lock_guard<std::mutex> lock(Current->Mutex);
+  Current->OnAcknowledgement = nullptr;
+}
+
+bool Synavis::DataConnector::DispatchTransferMessage(const JsonView& Message)
+{
+  // only the type and the id are read here, the members of an answer are read by the transfer
+  const auto type = Message.Type();
+  const bool error = type == "error";
+  if (!error && type != "buffer")
+    return false;
+  std::vector<std::shared_ptr<Transfer>> targets;
+  {
+    std::lock_guard<std::mutex> lock(TransferMutex);
+    if (const auto id = Message.Number<int>("player_id"); id.has_value())
+    {
+      // larger ids belong to requests, see RequestTracker
+      if (id.value() < 0 || id.value() >= static_cast<int>(RequestTracker::FirstId))
+        return false;
+      auto it = Transfers.find(static_cast<uint16_t>(id.value()));
+      if (it != Transfers.end())
+        targets.push_back(it->second);
+    }
+    else if (!error && Transfers.size() == 1)
+    {
+      // answers without an id come from peers that do not echo it, they can only be
+      // attributed if there is a single transfer. An error without an id may belong to any
+      // command, so it never fails a transfer, which then runs into its time out instead
+      targets.push_back(Transfers.begin()->second);
+    }
+  }
+  if (targets.empty())
+  {
+    return false;
+  }
+  for (auto& transfer : targets)
+  {
+    {
+      std::lock_guard<std::mutex> lock(transfer->Mutex);
+      if (error)
+        transfer->Failed = true;
+      else if (transfer->OnAcknowledgement)
+        transfer->OnAcknowledgement(Message);
+    }
+    transfer->Condition.notify_all();
+  }
+  // errors are of interest to the application as well
+  return !error;
+}
+
+void Synavis::DataConnector::HandleMessage(std::string_view Message)
+{
+  const JsonView view(Message);
+  if (Requests.HasPending() && Requests.Complete(view))
+    return;
+  if (view.Type() == "track")
+  {
+    if (Scene.IsEnabled())
+      Scene.Update(view);
+    if (const auto history = History.load())
+      history->Update(view);
+  }
+  if (HasActiveTransfers() && DispatchTransferMessage(view))
+    return;
+  if (Router.Dispatch(view))
+    return;
+  if (MessageViewCallback.has_value())
+    MessageViewCallback.value()(Message);
+  if (MessageReceptionCallback.has_value())
+    MessageReceptionCallback.value()(std::string(Message));
+}
+
+bool Synavis::DataConnector::HasActiveTransfers()
+{
+  std::lock_guard<std::mutex> lock(TransferMutex);
+  return !Transfers.empty();
+}
+
+bool Synavis::DataConnector::TransmitChunks(std::size_t Chunks, std::size_t ChunkSize,
+  const std::function<std::size_t(std::size_t, uint8_t*)>& WriteChunk, std::optional<json> StartMessage, std::optional<json> StopMessage,
+  std::shared_ptr<Transfer> Current)
+{
+  using clock = std::chrono::steady_clock;
+  // a transfer that is passed in stays open for further rounds of the caller
+  const bool owned = !Current;
+  if (owned)
+    Current = OpenTransfer();
+  // the answers of the peer carry the transfer id and are dispatched to this transfer, so that
+  // other transfers and the message callback are not disturbed. The data channel is ordered and
+  // reliable, so every answer acknowledges all frames before it and counting them is sufficient
+  const std::size_t first_chunk = StartMessage.has_value() ? 1 : 0;
+  // window estimation: the bandwidth-delay product in chunks, from the smallest round trip
+  // and the smoothed interval between two acknowledgements
+  const bool adaptive = AdaptiveTransferWindow && MaxTransferWindow > 1;
+  std::atomic<std::size_t> Window{ adaptive ? std::min(InitialTransferWindow, MaxTransferWindow) : MaxTransferWindow };
+  std::vector<std::atomic<int64_t>> sent_at(Chunks);
+  double min_rtt = std::numeric_limits<double>::max();
+  double ack_interval = 0.0;
+  std::optional<clock::time_point> last_ack;
+  {
+    std::lock_guard<std::mutex> lock(Current->Mutex);
+    Current->Acknowledged = 0;
+    Current->Failed = false;
+    // runs under the mutex of the transfer
+    Current->OnAcknowledgement = [&, this](const JsonView&)
+    {
+      const auto now = clock::now();
+      const std::size_t count = ++Current->Acknowledged;
+      if (!adaptive || count <= first_chunk || count > first_chunk + Chunks)
+        return;
+      const auto chunk_sent = clock::time_point(clock::duration(sent_at[count - first_chunk - 1].load()));
+      min_rtt = std::min(min_rtt, std::chrono::duration<double>(now - chunk_sent).count());
+      if (last_ack.has_value())
+      {
+        const double interval = std::chrono::duration<double>(now - last_ack.value()).count();
+        ack_interval = (ack_interval > 0.0) ? 0.875 * ack_interval + 0.125 * interval : interval;
+      }
+      last_ack = now;
+      if (ack_interval > 0.0)
+      {
+        const auto bdp = static_cast<std::size_t>(std::ceil(min_rtt / ack_interval)) + 1;
+        Window = std::clamp(bdp, static_cast<std::size_t>(1), MaxTransferWindow);
+      }
+    };
+  }
+  // waits until Target answers have arrived, fails after TimeOut seconds without progress if FailIfNotComplete is set
+  auto WaitForAcknowledged = [&Current, this](std::size_t Target)
+  {
+    if (DontWaitForAnswer)
+      return;
+    std::optional<clock::time_point> deadline;
+    if (FailIfNotComplete)
+      deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(TimeOut));
+    std::unique_lock<std::mutex> lock(Current->Mutex);
+    if (!Waits.Wait(Current->Condition, lock, deadline, [&]() { return Current->Acknowledged >= Target || Current->Failed; }))
+    {
+      lconnector(ELogVerbosity::Debug) << "Transfer " << Current->Id << " timed out while waiting for message " << Target << std::endl;
+      Current->Failed = true;
+    }
+  };
   // transmit
-  lconnector(ELogVerbosity::Debug) << "Transmitting buffer of size " << Buffer.size() << " in " << chunks << " chunks of size " << chunk_size << std::endl;
-  this->SendJSON({ {"type","buffer"}, {"start",Name }, {"size", total_size}, {"format", Format} });
-  lconnector(ELogVerbosity::Debug) << "Sent start message" << std::endl;
-  if (!DontWaitForAnswer)
+  if (StartMessage.has_value())
   {
-    WaitTimeout(this->FailIfNotComplete, TimeOut);
-    lconnector(ELogVerbosity::Debug) << "Received start message" << std::endl;
+    StartMessage.value()["pid"] = Current->Id;
+    this->SendJSON(StartMessage.value());
+    FlushBatch();
+    lconnector(ELogVerbosity::Debug) << "Sent start message of transfer " << Current->Id << std::endl;
+    WaitForAcknowledged(1);
   }
-  rtc::binary bytes(std::min(chunk_size, total_size) + 4);
-  bytes.at(bytes.size() - 1) = std::byte(0);
-  uint8_t* buffer = reinterpret_cast<uint8_t*>(&(bytes.at(3)));
-  bytes.at(0) = DataChannelByte;
+  FlushBatch();
+  // peers that announced extended frames get a uint32 length field and correspondingly larger chunks
+  const bool extended = UsesExtendedFrames();
+  const std::size_t header_size = extended ? PooledFrame::ExtendedHeaderSize : PooledFrame::HeaderSize;
+  rtc::binary bytes(ChunkSize + header_size + 1);
+  uint8_t* buffer = reinterpret_cast<uint8_t*>(&(bytes.at(header_size)));
+  bytes.at(0) = extended ? ExtendedDataChannelByte : DataChannelByte;
   // move through the chunks
-  lconnector(ELogVerbosity::Verbose) << "Message state is " << MessageState << " chunk info " << total_size << "->" << chunk_size << "(" << chunks << ")" << std::endl;
-  for (int i = 0; i < chunks && MessageState > 0; i++)
+  lconnector(ELogVerbosity::Verbose) << "Chunk info " << ChunkSize << "(" << Chunks << "), window " << Window << " of " << MaxTransferWindow << std::endl;
+  for (std::size_t i = 0; i < Chunks && !Current->Failed; i++)
   {
-    const auto remaining = std::min(chunk_size, total_size - i * chunk_size);
-    if (bytes.size() > remaining + 4)
+    // keep at most Window chunks without acknowledgement in flight, a window of one is stop-and-wait
+    const std::size_t window = Window;
+    if (i >= window)
     {
-      bytes.resize(remaining + 4);
-      bytes.at(bytes.size() - 1) = std::byte(0);
+      WaitForAcknowledged(first_chunk + i - window + 1);
+      if (Current->Failed)
+        break;
     }
-    // copy the chunk into the buffer, the std::min is to avoid copying too much
-    memcpy(buffer, Source + i * chunk_size, remaining);
-    // set the second and third bytes to the chunk size
-    *(reinterpret_cast<uint16_t*>(&(bytes.at(1)))) = static_cast<uint16_t>(remaining);
-    // send the buffer
-    lconnector(ELogVerbosity::Debug) << "Sending chunk " << i << " of length " << remaining << std::endl;
-    DataChannel->sendBuffer(bytes);
-    // wait for the message to be received
-    if (!DontWaitForAnswer)
+    // fill the chunk right before it is sent, only one chunk is held in memory
+    const auto length = WriteChunk(i, buffer);
+    // only the last chunk can be shorter than the frame
+    bytes.resize(length + header_size + 1);
+    bytes.at(bytes.size() - 1) = std::byte(0);
+    // the length field follows the type byte
+    if (extended)
+    {
+      const auto length_field = static_cast<uint32_t>(length);
+      memcpy(&(bytes.at(1)), &length_field, sizeof(length_field));
+    }
+    else
     {
-      WaitTimeout(this->FailIfNotComplete, TimeOut);
-      lconnector(ELogVerbosity::Debug) << "Received message " << i << std::endl;
+      const auto length_field = static_cast<uint16_t>(length);
+      memcpy(&(bytes.at(1)), &length_field, sizeof(length_field));
     }
+    // send the buffer
+    lconnector(ELogVerbosity::Debug) << "Sending chunk " << i << " of length " << length << std::endl;
+    sent_at[i] = clock::now().time_since_epoch().count();
+    Transmit(bytes, ESendPriority::Bulk);
   }
-  this->SendJSON({ {"type","buffer"},{"stop",Name} });
-    if (!DontWaitForAnswer) WaitTimeout(this->FailIfNotComplete, TimeOut);
+  // wait for the remaining chunks
+  WaitForAcknowledged(first_chunk + Chunks);
+  lconnector(ELogVerbosity::Debug) << "Received " << Current->Acknowledged << " answers, final window " << Window << std::endl;
+  LastTransferWindow = Window;
+  if (StopMessage.has_value())
+  {
+    StopMessage.value()["pid"] = Current->Id;
+    this->SendJSON(StopMessage.value());
+    FlushBatch();
+    WaitForAcknowledged(first_chunk + Chunks + 1);
     lconnector(ELogVerbosity::Info) << "Sent stop message" << std::endl;
-    // restore the original callback
-      MessageReceptionCallback = msg_callback;
-    if (NeedToDelete)
+  }
+  if (owned)
+  {
+    CloseTransfer(Current);
+  }
+  else
+  {
+    // the acknowledgement handler refers to this stack frame
+    std::lock_guard<std::mutex> lock(Current->Mutex);
+    Current->OnAcknowledgement = nullptr;
+  }
+  return this->DontWaitForAnswer || !Current->Failed;
+}
+
+bool Synavis::DataConnector::TransmitResumable(std::size_t Chunks, std::size_t ChunkSize,
+  const std::function<std::size_t(std::size_t, uint8_t*)>& WriteChunk, json StartMessage, json StopMessage)
+{
+  auto transfer = OpenTransfer();
+  const std::string name = StartMessage["start"].get<std::string>();
+  StartMessage["chunk"] = ChunkSize;
+  StartMessage["chunks"] = Chunks;
+  StartMessage["checksum"] = "crc32c";
+  // the payload of a chunk is written behind its header, the checksum is computed in place
+  auto WriteChecked = [&WriteChunk](std::size_t i, uint8_t* Target)
+  {
+    CheckedChunkHeader header{};
+    header.Index = static_cast<uint32_t>(i);
+    header.Length = static_cast<uint32_t>(WriteChunk(i, Target + sizeof(header)));
+    header.Crc = Crc32c(Target + sizeof(header), header.Length);
+    memcpy(Target, &header, sizeof(header));
+    return sizeof(header) + header.Length;
+  };
+  std::vector<std::size_t> pending(Chunks);
+  std::iota(pending.begin(), pending.end(), std::size_t{ 0 });
+  bool started = false;
+  for (std::size_t attempt = 0; attempt <= ResumeAttempts && !pending.empty(); ++attempt)
+  {
+    if (attempt > 0)
+    {
+      lconnector(ELogVerbosity::Info) << "Resuming transfer " << transfer->Id << " at chunk " << pending.front() << " with " << pending.size() << " chunks missing" << std::endl;
+    }
+    this->TransmitChunks(pending.size(), ChunkSize + sizeof(CheckedChunkHeader),
+      [&pending, &WriteChecked](std::size_t k, uint8_t* Target) { return WriteChecked(pending[k], Target); },
+      started ? std::nullopt : std::optional<json>(StartMessage), std::nullopt, transfer);
+    // the start is only repeated if the peer did not answer it
+    started = started || transfer->Acknowledged > 0;
+    if (!started)
+      continue;
+    const auto bitmap = QueryChunkBitmap(transfer, name);
+    if (!bitmap.has_value())
+      continue;
+    std::erase_if(pending, [&bitmap](std::size_t i)
+      {
+        return i / 8 < bitmap.value().size() && (bitmap.value()[i / 8] & (1u << (i % 8))) != 0;
+      });
+  }
+  bool complete = pending.empty();
+  if (complete)
+  {
+    complete = this->TransmitChunks(0, 0, WriteChunk, std::nullopt, std::move(StopMessage), transfer);
+  }
+  else
+  {
+    lconnector(ELogVerbosity::Warning) << "Transfer " << transfer->Id << " of " << name << " is missing " << pending.size() << " chunks after " << ResumeAttempts << " attempts" << std::endl;
+  }
+  CloseTransfer(transfer);
+  return complete;
+}
+
+std::optional<std::vector<uint8_t>> Synavis::DataConnector::QueryChunkBitmap(const std::shared_ptr<Transfer>& Current, const std::string& Name)
+{
+  std::promise<std::vector<uint8_t>> Answer;
+  auto Result = Answer.get_future();
+  bool answered = false;
+  {
+    std::lock_guard<std::mutex> lock(Current->Mutex);
+    Current->OnAcknowledgement = [&Answer, &answered](const JsonView& Content)
+    {
+      const auto bitmap = Content.String("bitmap");
+      if (answered || Content.String("state") != "bitmap" || !bitmap.has_value())
+        return;
+      answered = true;
+      try
+      {
+        Answer.set_value(Base64Decode(bitmap.value()));
+      }
+      catch (const std::runtime_error&)
+      {
+        Answer.set_value({});
+      }
+    };
+  }
+  this->SendJSON({ {"type","buffer"},{"query",Name},{"pid",Current->Id} });
+  FlushBatch();
+  const auto deadline = WaitMetric::clock::now() + std::chrono::duration_cast<WaitMetric::clock::duration>(std::chrono::duration<double>(TimeOut));
+  const bool received = Waits.Wait(Result, deadline);
+  {
+    std::lock_guard<std::mutex> lock(Current->Mutex);
+    Current->OnAcknowledgement = nullptr;
+  }
+  if (!received)
+  {
+    lconnector(ELogVerbosity::Warning) << "Peer did not report the chunks of transfer " << Current->Id << std::endl;
+    return std::nullopt;
+  }
+  return Result.get();
+}
+
+bool Synavis::DataConnector::QueryBinaryGeometrySupport()
+{
+  return PeerSupports("binarygeometry");
+}
+
+bool Synavis::DataConnector::PeerSupports(std::string_view Capability)
+{
+  std::lock_guard<std::mutex> lock(CapabilityMutex);
+  const auto& capabilities = QueryPeerCapabilitiesLocked();
+  return std::ranges::find(capabilities, Capability) != capabilities.end();
+}
+
+std::vector<std::string> Synavis::DataConnector::QueryPeerCapabilities()
+{
+  std::lock_guard<std::mutex> lock(CapabilityMutex);
+  return QueryPeerCapabilitiesLocked();
+}
+
+const std::vector<std::string>& Synavis::DataConnector::QueryPeerCapabilitiesLocked()
+{
+  // the answer arrives through HandleMessage, which does not take CapabilityMutex
+  if (PeerCapabilities.has_value())
+  {
+    return PeerCapabilities.value();
+  }
+  if (DontWaitForAnswer)
+  {
+    // without answers there is no way to learn about the peer
+    static const std::vector<std::string> none;
+    return none;
+  }
+  // peers that predate the capability query do not answer at all, so we do not wait for the full timeout
+  auto answer = Request({ {"type","info"},{"capabilities","query"} }, std::min(TimeOut, 2.0));
+  FlushBatch();
+  std::vector<std::string> names;
+  try
+  {
+    Waits.Wait(answer, std::nullopt);
+    const auto info = answer.get();
+    if (const auto capabilities = info.find("capabilities"); capabilities != info.end() && capabilities->is_array())
     {
-      delete[] Source;
+      for (const auto& capability : *capabilities)
+        if (capability.is_string())
+          names.push_back(capability.get<std::string>());
     }
-  return this->DontWaitForAnswer || MessageState > 0;
+  }
+  catch (const std::exception& e)
+  {
+    lconnector(ELogVerbosity::Info) << "Peer did not report its capabilities: " << e.what() << std::endl;
+  }
+  PeerCapabilities = std::move(names);
+  lconnector(ELogVerbosity::Info) << "Peer reports " << PeerCapabilities.value().size() << " capabilities" << std::endl;
+  return PeerCapabilities.value();
+}
+
+std::shared_ptr<Synavis::TrackHistory> Synavis::DataConnector::SetTrackHistory(std::size_t Capacity)
+{
+  auto history = (Capacity > 0) ? std::make_shared<TrackHistory>(Capacity) : nullptr;
+  History.store(history);
+  return history;
+}
+
+std::future<Synavis::DataConnector::json> Synavis::DataConnector::Request(json Message, double TimeoutSeconds)
+{
+  auto answer = std::make_shared<std::promise<json>>();
+  auto result = answer->get_future();
+  SendRequest(std::move(Message), [answer](json Answer, std::exception_ptr Error)
+    {
+      if (Error)
+        answer->set_exception(Error);
+      else
+        answer->set_value(std::move(Answer));
+    }, TimeoutSeconds);
+  return result;
+}
+
+void Synavis::DataConnector::SendRequest(json Message, RequestTracker::Completion Done, double TimeoutSeconds)
+{
+  using clock = RequestTracker::clock;
+  if (TimeoutSeconds <= 0.0)
+    TimeoutSeconds = TimeOut;
+  const auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(TimeoutSeconds));
+  const auto id = Requests.Open(deadline, std::move(Done));
+  if (this->state_ != EConnectionState::CONNECTED)
+  {
+    Requests.Fail(id, std::make_exception_ptr(std::runtime_error("Cannot send a request without a connection")));
+    return;
+  }
+  Message["pid"] = id;
+  this->SendJSON(Message);
+}
+
+bool Synavis::DataConnector::RequestAwaitable::await_suspend(std::coroutine_handle<> Handle)
+{
+  Connector.SendRequest(std::move(Message), [this, Handle](json inAnswer, std::exception_ptr inError)
+    {
+      Answer = std::move(inAnswer);
+      Error = inError;
+      if (Completed.exchange(true))
+        Handle.resume();
+    }, TimeoutSeconds);
+  // an answer that is already there, e.g. the error of a closed connection, resumes right away
+  return !Completed.exchange(true);
+}
+
+Synavis::DataConnector::json Synavis::DataConnector::RequestAwaitable::await_resume()
+{
+  if (Error)
+    std::rethrow_exception(Error);
+  return std::move(Answer);
 }
 
 bool Synavis::DataConnector::SendFloat64Buffer(const std::vector<double>& Buffer, std::string Name, std::string Format)
@@ -282,8 +1237,11 @@ void Synavis::DataConnector::SendGeometry(const std::vector<double>& Vertices, c
   {
     total_size += EncodedSize(Tangents.value());
   }
+  // raw frames are only used if the peer can parse them, a single json message is preferred if it fits
+  const bool binary = (GeometryTransfer == EGeometryTransfer::Binary)
+    || (GeometryTransfer == EGeometryTransfer::Automatic && total_size >= GetMaxFramePayload() && QueryBinaryGeometrySupport());
   // check if we can send the message as a single buffer
-  if (total_size < this->MaxMessageSize)
+  if (!binary && total_size < GetMaxFramePayload())
   {
     Message["type"] = "directbase64";
     Message["points"] = Encode64(Vertices);
@@ -304,36 +1262,38 @@ void Synavis::DataConnector::SendGeometry(const std::vector<double>& Vertices, c
   }
   else
   {
-    bool state = false;
-    std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(Vertices.data()), reinterpret_cast<const uint8_t*>(Vertices.data() + Vertices.size()));
-    // send the vertices
-    do { state = this->SendBuffer(data, "points", "base64"); } while (!state && RetryOnErrorResponse);
-    state = false;
-    // send the indices
-    data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Indices.data()), Indices.size() * sizeof(float));
-    do { state = this->SendBuffer(data, "triangles", "base64"); } while (!state && RetryOnErrorResponse);
-    state = false;
-    // send the normals
-    if (UVs.has_value())
+    // references to arrays that the peer holds are answered while the next arrays go out,
+    // the arrays outlive the answers because they are resolved before this returns
+    std::vector<DeferredReference> deferred;
+    auto SendArray = [this, binary, &deferred](const auto& Array, std::string ArrayName, EBinaryElementType Type)
+    {
+      const std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(Array.data()), ByteSize(Array));
+      const std::string kind = binary ? "binary" + std::to_string(static_cast<unsigned>(Type)) : std::string("base64");
+      const std::function<bool(void)> upload = [this, binary, data, ArrayName, Type]()
+      {
+        return binary ? this->TransmitBinaryArray(data, ArrayName, Type) : this->TransmitBuffer(data, ArrayName, "base64");
+      };
+      bool state = false;
+      do
+      {
+        state = this->SendDeduplicated(data, ArrayName, kind, upload, &deferred);
+      } while (!state && RetryOnErrorResponse);
+    };
+    SendArray(Vertices, "points", EBinaryElementType::Float64);
+    SendArray(Indices, "triangles", EBinaryElementType::UInt32);
+    if (Normals.has_value())
     {
-      data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Normals.value().data()), Normals.value().size() * sizeof(float));
-      do { state = this->SendBuffer(data, "normals", "base64"); } while (!state && RetryOnErrorResponse);
-      state = false;
+      SendArray(Normals.value(), "normals", EBinaryElementType::Float64);
     }
-    // send the UVs
     if (UVs.has_value())
     {
-      data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(UVs.value().data()), UVs.value().size() * sizeof(float));
-      do { state = this->SendBuffer(data, "uvs", "base64"); } while (!state && RetryOnErrorResponse);
-      state = false;
+      SendArray(UVs.value(), "uvs", EBinaryElementType::Float64);
     }
-    // send the tangents
     if (Tangents.has_value())
     {
-      data = std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Tangents.value().data()), Tangents.value().size() * sizeof(float));
-      do { state = this->SendBuffer(data, "tangents", "base64"); } while (!state && RetryOnErrorResponse);
-      state = false;
+      SendArray(Tangents.value(), "tangents", EBinaryElementType::Float64);
     }
+    ResolveReferences(deferred);
     if (AutoMessage)
       this->SendJSON({ {"type","spawn"},{"object","ProceduralMeshComponent"} });
   }
@@ -418,14 +1378,16 @@ void Synavis::DataConnector::PrintCommunicationData()
   lconnector(ELogVerbosity::Info) << "Data Channel " << label << " has protocol " << protocol << " and max message size " << max_message << std::endl;
 }
 
-void Synavis::DataConnector::LockUntilConnected(unsigned additional_wait)
+bool Synavis::DataConnector::LockUntilConnected(unsigned additional_wait, double timeout)
 {
-  while (state_ < EConnectionState::CONNECTED)
+  if (!WaitForState(EConnectionState::CONNECTED, timeout))
   {
-    std::this_thread::yield();
+    lconnector(ELogVerbosity::Warning) << "Connection was not established within " << timeout << " seconds" << std::endl;
+    return false;
   }
   if(additional_wait > 0)
     std::this_thread::sleep_for(std::chrono::milliseconds(additional_wait));
+  return true;
 }
 
 void Synavis::DataConnector::CommunicateSDPs()
@@ -465,149 +1427,114 @@ void Synavis::DataConnector::exp__DeactivateCallbacks()
   lconnector(ELogVerbosity::Warning) << "Deactivating experimental message reception also clears callback" << std::endl;
 }
 
-inline void Synavis::DataConnector::DataChannelMessageHandling(rtc::message_variant messageordata)
+void Synavis::DataConnector::DataChannelMessageHandling(rtc::message_variant messageordata)
 {
-  if (std::holds_alternative<rtc::binary>(messageordata))
+  if (const auto* message = std::get_if<std::string>(&messageordata))
   {
-    auto data = std::get<rtc::binary>(messageordata);
-    std::byte message_byte = data[0];
-    if(message_byte == 0_b)
-    {
-      // Quality control ownership
-      lconnector(ELogVerbosity::Verbose) << "Received quality control ownership" << std::endl;
-    }
-    else if (message_byte == 1_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received response" << std::endl;
-    }
-    else if(message_byte == 2_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received command" << std::endl;
-    }
-    else if (message_byte == 3_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received freeze frame" << std::endl;
-    }
-    else if (message_byte == 3_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received freeze frame" << std::endl;
-    }
-    else if (message_byte == 4_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received unfreeze frame" << std::endl;
-    }
-    else if(message_byte == 5_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Received video encoder AVgQP" << std::endl;
-    }
-    else if (message_byte == 6_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Latency Test" << std::endl;
-    }
-    else if (message_byte == 7_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Initial Settings" << std::endl;
-    }
-    else if (message_byte == 8_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "File Extension" << std::endl;
-    }
-    else if (message_byte == 9_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "File MIME Type" << std::endl;
-    }
-    else if (message_byte == 10_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "File Content" << std::endl;
-    }
-    else if (message_byte == 11_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Test Echo" << std::endl;
-    }
-    else if (message_byte == 12_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Input Control Ownership" << std::endl;
-    }
-    else if (message_byte == 13_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Gamepad response" << std::endl;
-    }
-    else if (message_byte == 255_b)
-    {
-      lconnector(ELogVerbosity::Verbose) << "Protocoll" << std::endl;
-    }
-    if (message_byte != 1_b && message_byte != 255_b && message_byte != 7_b)
-      return;
-    if (data.size() < 5) // {a:1}
-    {
-      if (DataReceptionCallback.has_value())
-        DataReceptionCallback.value()(data);
-      return;
-    }
-    try
-    {
-      // try parse string
-      std::string_view message(reinterpret_cast<char*>(data.data() + 1), data.size());
-      // the first character pair to see if the string is wchar_t or char
-      if (message[1] == '\0' && message[3] == '\0')
-      {
-        // wchar_t
-        lconnector(ELogVerbosity::Verbose) << "We assume that the 0x00 characters mean that the string is wchar_t" << std::endl;
-        auto wstringview = std::wstring_view(reinterpret_cast<wchar_t*>(data.data() + 1), data.size() / sizeof(wchar_t));
-        char* cstr = new char[wstringview.size()];
-        std::size_t it = 0;
-        std::generate(cstr, cstr + wstringview.size(), [&wstringview, &it]() { return static_cast<char>(wstringview[it++]); });
-        message = std::string_view(cstr, wstringview.size());
-      }
-      // find readable json subset
-      auto first_lbrace = message.find_first_of('{');
-      // find the rbrace that closes this lbrace by counting the braces
-      auto last_rbrace = first_lbrace;
-      int brace_count = 1;
-      for (auto i = first_lbrace + 1; i < message.length(); i++)
-      {
-        if (message[i] == '{')
-          brace_count++;
-        else if (message[i] == '}')
-          brace_count--;
-        if (brace_count == 0)
-        {
-          last_rbrace = i;
-          break;
-        }
-      }
+    lconnector(ELogVerbosity::Verbose) << "Direct message reception of size " << message->size() << std::endl;
+    HandleMessage(*message);
+    return;
+  }
+  const auto& data = std::get<rtc::binary>(messageordata);
+  if (data.empty())
+    return;
+  // fragments of a message that the peer had to split up, the whole message comes back through here
+  if (InsertFragment(FragmentAssembler, data))
+    return;
+  // the handlers receive views into the message, it is only copied by those that keep it
+  const auto& handler = FrameHandlers[std::to_integer<uint8_t>(data[0])];
+  if (handler)
+    handler(data);
+}
 
-      if (first_lbrace < message.length() && last_rbrace < message.length())
-        //&& std::ranges::all_of(message.begin() + first_lbrace, message.begin() + last_rbrace, &isprint))
-      {
+void Synavis::DataConnector::SetFrameHandler(uint8_t Type, FrameHandler Handler)
+{
+  FrameHandlers[Type] = std::move(Handler);
+}
 
-        lconnector(ELogVerbosity::Verbose) << "Decoded message reception of size " << last_rbrace - first_lbrace + 1 << " of " << message.length() << std::endl;
-        if (MessageReceptionCallback.has_value())
-          MessageReceptionCallback.value()(std::string(message.substr(first_lbrace, last_rbrace - first_lbrace + 1)));
-      }
-      else if (DataReceptionCallback.has_value())
+void Synavis::DataConnector::RegisterFrameHandlers()
+{
+  // message types of the Unreal pixel streaming protocol that we only take note of
+  static constexpr std::array<std::string_view, 14> names = {
+    "Received quality control ownership", "Received response", "Received command", "Received freeze frame",
+    "Received unfreeze frame", "Received video encoder AVgQP", "Latency Test", "Initial Settings",
+    "File Extension", "File MIME Type", "File Content", "Test Echo", "Input Control Ownership", "Gamepad response" };
+  for (std::size_t type = 0; type < names.size(); ++type)
+  {
+    FrameHandlers[type] = [this, name = names[type]](std::span<const std::byte>)
       {
-        lconnector(ELogVerbosity::Verbose) << "Received data of size " << data.size() << std::endl;
-        DataReceptionCallback.value()(data);
-      }
+        lconnector(ELogVerbosity::Verbose) << name << std::endl;
+      };
+  }
+  // responses, the initial settings and the protocol carry text
+  FrameHandlers[1] = FrameHandlers[7] = FrameHandlers[255] = std::bind(&DataConnector::HandleTextFrame, this, std::placeholders::_1);
+  FrameHandlers[std::to_integer<uint8_t>(ExtendedDataChannelByte)] = std::bind(&DataConnector::HandleExtendedFrame, this, std::placeholders::_1);
+}
+
+void Synavis::DataConnector::HandleExtendedFrame(std::span<const std::byte> Frame)
+{
+  if (Frame.size() < PooledFrame::ExtendedOverhead)
+    return;
+  uint32_t length;
+  memcpy(&length, Frame.data() + 1, sizeof(length));
+  length = static_cast<uint32_t>(std::min<std::size_t>(length, Frame.size() - PooledFrame::ExtendedOverhead));
+  const auto payload = Frame.subspan(PooledFrame::ExtendedHeaderSize, length);
+  lconnector(ELogVerbosity::Verbose) << "Received extended frame of size " << length << std::endl;
+  if (length > 0 && payload[0] == std::byte('{'))
+    HandleMessage(std::string_view(reinterpret_cast<const char*>(payload.data()), payload.size()));
+  else
+    DeliverData(payload);
+}
+
+void Synavis::DataConnector::HandleTextFrame(std::span<const std::byte> Frame)
+{
+  lconnector(ELogVerbosity::Verbose) << "Received text frame of type " << std::to_integer<int>(Frame[0]) << std::endl;
+  if (Frame.size() < 6) // type and {a:1}
+  {
+    DeliverData(Frame);
+    return;
+  }
+  try
+  {
+    std::string_view message(reinterpret_cast<const char*>(Frame.data() + 1), Frame.size() - 1);
+    // the first character pair to see if the string is wchar_t or char
+    if (message[1] == '\0' && message[3] == '\0')
+    {
+      lconnector(ELogVerbosity::Verbose) << "We assume that the 0x00 characters mean that the string is wchar_t" << std::endl;
+      // the buffer keeps its capacity, so only the first wide messages of a thread allocate
+      thread_local std::string narrow;
+      Utf16ToUtf8(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(message.data()), message.size()), narrow);
+      message = narrow;
+    }
+    // the json reaches from the first opening to the last closing brace, whatever surrounds it is framing
+    const auto first_lbrace = message.find('{');
+    const auto last_rbrace = message.rfind('}');
+    if (first_lbrace != std::string_view::npos && last_rbrace != std::string_view::npos && first_lbrace < last_rbrace)
+    {
+      lconnector(ELogVerbosity::Verbose) << "Decoded message reception of size " << last_rbrace - first_lbrace + 1 << " of " << message.length() << std::endl;
+      HandleMessage(message.substr(first_lbrace, last_rbrace - first_lbrace + 1));
     }
-    catch (const std::exception&)
+    else
     {
-      lconnector(ELogVerbosity::Warning) << "Encountered an error while trying to parse a string from the package." << std::endl;
-      lconnector(ELogVerbosity::Verbose) << "Error was: " << std::current_exception << std::endl;
-      lconnector(ELogVerbosity::Verbose) << "From data of size " << data.size() << std::endl;
-      lconnector(ELogVerbosity::Verbose) << "And first 10 characters: " << std::string(reinterpret_cast<char*>(data.data()), std::min(data.size(), static_cast<std::size_t>(10))) << std::endl;
+      lconnector(ELogVerbosity::Verbose) << "Received data of size " << Frame.size() << std::endl;
+      DeliverData(Frame);
     }
   }
-  else
+  catch (const std::exception&)
   {
-    auto message = std::get<std::string>(messageordata);
-    lconnector(ELogVerbosity::Verbose) << "Direct message reception of size " << message.size() << std::endl;
-    if (MessageReceptionCallback.has_value())
-      MessageReceptionCallback.value()(message);
+    lconnector(ELogVerbosity::Warning) << "Encountered an error while trying to parse a string from the package." << std::endl;
+    lconnector(ELogVerbosity::Verbose) << "From data of size " << Frame.size() << std::endl;
   }
 }
 
+void Synavis::DataConnector::DeliverData(std::span<const std::byte> Data)
+{
+  if (DataViewCallback.has_value())
+    DataViewCallback.value()(Data);
+  if (DataReceptionCallback.has_value())
+    DataReceptionCallback.value()(rtc::binary(Data.begin(), Data.end()));
+}
+
 void Synavis::DataConnector::Initialize()
 {
   if (IP.has_value()) rtcconfig_.bindAddress = IP.value();
@@ -643,7 +1570,24 @@ void Synavis::DataConnector::Initialize()
     });
   PeerConnection->onDataChannel([this](auto datachannel)
     {
+      if (datachannel->label().starts_with(StripeChannelLabel))
+      {
+        lconnector(ELogVerbosity::Info) << "Peer opened stripe channel " << datachannel->label() << std::endl;
+        AddStripeChannel(datachannel);
+        return;
+      }
+      if (datachannel->label() == TelemetryChannelLabel)
+      {
+        lconnector(ELogVerbosity::Info) << "Peer opened a telemetry channel" << std::endl;
+        AddTelemetryChannel(datachannel);
+        return;
+      }
       lconnector(ELogVerbosity::Warning) << "I received a channel I did not ask for" << std::endl;
+      if (datachannel->protocol() == ExtendedFramingProtocol)
+      {
+        lconnector(ELogVerbosity::Info) << "Peer announced extended frames" << std::endl;
+        PeerSupportsExtendedFrames = true;
+      }
       datachannel->onOpen([this]()
         {
           lconnector(ELogVerbosity::Warning) << "THEIR DataChannel connection is setup!" << std::endl;
@@ -676,7 +1620,12 @@ void Synavis::DataConnector::Initialize()
       }
     });
   SignallingServer = std::make_shared<rtc::WebSocket>();
-  DataChannel = PeerConnection->createDataChannel("DataConnectionChannel");
+  rtc::DataChannelInit data_init;
+  if (ExtendedFraming)
+  {
+    data_init.protocol = std::string(ExtendedFramingProtocol);
+  }
+  DataChannel = PeerConnection->createDataChannel("DataConnectionChannel", data_init);
   DataChannel->onOpen([this]()
     {
       lconnector(ELogVerbosity::Info) << "OUR DataChannel connection is setup!" << std::endl;
@@ -691,8 +1640,12 @@ void Synavis::DataConnector::Initialize()
         lconnector(ELogVerbosity::Warning) << "****************************************************************************" << std::endl;
       }
       this->MaxMessageSize = std::min(DataChannel->maxMessageSize(), static_cast<std::size_t>(std::numeric_limits<uint16_t>::max() - 3));
+      if (const auto batcher = Batcher.load())
+      {
+        batcher->SetMaxPayload(this->MaxMessageSize - 4);
+      }
     
-      state_ = EConnectionState::CONNECTED;
+      SetState(EConnectionState::CONNECTED);
     });
   DataChannel->onMessage(std::bind(&DataConnector::DataChannelMessageHandling, this, std::placeholders::_1));
   DataChannel->onError([this](std::string error)
@@ -705,22 +1658,55 @@ void Synavis::DataConnector::Initialize()
       if (OnDataChannelAvailableCallback.has_value())
         OnDataChannelAvailableCallback.value()();
     });
+  DataChannel->setBufferedAmountLowThreshold(GetBufferedAmountLowThreshold());
   DataChannel->onBufferedAmountLow([this]()
     {
-      lconnector(ELogVerbosity::Info) << "DataChannel buffered amount low" << std::endl;
+      lconnector(ELogVerbosity::Verbose) << "DataChannel buffered amount low" << std::endl;
+      {
+        std::lock_guard<std::mutex> lock(BufferMutex);
+      }
+      BufferCondition.notify_all();
     });
   DataChannel->onClosed([this]()
     {
       lconnector(ELogVerbosity::Info) << "DataChannel is CLOSED again" << std::endl;
-      this->state_ = EConnectionState::CLOSED;
+      SetState(EConnectionState::CLOSED);
       if (OnClosedCallback.has_value())
       {
         OnClosedCallback.value()();
       }
     });
+  rtc::DataChannelInit stripe_init;
+  // the assembler orders the pieces, so a stripe does not need to wait for its own earlier pieces either
+  stripe_init.reliability.unordered = true;
+  for (std::size_t i = 0; i < StripeChannelCount; ++i)
+  {
+    AddStripeChannel(PeerConnection->createDataChannel(std::string(StripeChannelLabel) + std::to_string(i), stripe_init));
+  }
+  if (TelemetryChannel)
+  {
+    // a newer sample supersedes a lost one, so it is neither waited for nor (for long) resent
+    rtc::DataChannelInit telemetry_init;
+    telemetry_init.reliability.unordered = true;
+    if (TelemetryLifetime > 0)
+    {
+      telemetry_init.reliability.type = rtc::Reliability::Type::Timed;
+      telemetry_init.reliability.rexmit = std::chrono::milliseconds(TelemetryLifetime);
+    }
+    else
+    {
+      telemetry_init.reliability.type = rtc::Reliability::Type::Rexmit;
+      telemetry_init.reliability.rexmit = 0;
+    }
+    if (ExtendedFraming)
+    {
+      telemetry_init.protocol = std::string(ExtendedFramingProtocol);
+    }
+    AddTelemetryChannel(PeerConnection->createDataChannel(std::string(TelemetryChannelLabel), telemetry_init));
+  }
   SignallingServer->onOpen([this]()
     {
-      state_ = EConnectionState::SIGNUP;
+      SetState(EConnectionState::SIGNUP);
       lconnector(ELogVerbosity::Info) << "Signalling server connected" << std::endl;
       if (TakeFirstStep)
       {
@@ -740,7 +1726,7 @@ void Synavis::DataConnector::Initialize()
           lconnector(ELogVerbosity::Info) << "PeerConnection has no Media!" << std::endl;
         }
         SignallingServer->send(offer.dump());
-        state_ = EConnectionState::OFFERED;
+        SetState(EConnectionState::OFFERED);
       }
     });
   SignallingServer->onMessage([this](auto messageordata)
@@ -840,7 +1826,7 @@ void Synavis::DataConnector::Initialize()
             lconnector(ELogVerbosity::Info) << "I have received all required candidates" << std::endl;
             if (!TakeFirstStep && PeerConnection->localDescription().has_value() && state_ < EConnectionState::OFFERED)
             {
-              this->state_ = EConnectionState::OFFERED;
+              SetState(EConnectionState::OFFERED);
               SubmissionHandler.AddTask(std::bind(&DataConnector::CommunicateSDPs, this));
             }
             if (OnIceGatheringFinished.has_value())
@@ -909,7 +1895,7 @@ void Synavis::DataConnector::Initialize()
     });
   SignallingServer->onClosed([this]()
     {
-      state_ = EConnectionState::CLOSED;
+      SetState(EConnectionState::CLOSED);
       auto unix_time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 
       lconnector(ELogVerbosity::Info) << "Signalling server was closed at timestamp " << unix_time << std::endl;
@@ -917,7 +1903,7 @@ void Synavis::DataConnector::Initialize()
     });
   SignallingServer->onError([this](std::string error)
     {
-      state_ = EConnectionState::STARTUP;
+      SetState(EConnectionState::STARTUP);
       SignallingServer->close();
       lconnector(ELogVerbosity::Error) << "Signalling server error: " << error << std::endl;
     });
@@ -5,10 +5,24 @@
 #include <json.hpp>
 #include <span>
 #include <variant>
+#include <unordered_map>
+#include <array>
+#include <coroutine>
+#include <future>
 #include <rtc/rtc.hpp>
 #include "Synavis/export.hpp"
 
 #include "Synavis.hpp"
+#include "FramePool.hpp"
+#include "MessageBatcher.hpp"
+#include "MessageAssembler.hpp"
+#include "Checksum.hpp"
+#include "JsonView.hpp"
+#include "MessageRouter.hpp"
+#include "RequestTracker.hpp"
+#include "SceneState.hpp"
+#include "TrackHistory.hpp"
+#include "ContentCache.hpp"
 #include <rtc/peerconnection.hpp>
 #include <rtc/datachannel.hpp>
 #include <rtc/configuration.hpp>
@@ -16,6 +30,94 @@
 namespace Synavis
 {
 
+// how SendGeometry puts the geometry arrays on the wire
+enum class SYNAVIS_EXPORT EGeometryTransfer
+{
+  Automatic = 0u, // binary frames if the peer reports support for them, base64 otherwise
+  Base64,
+  Binary
+};
+
+// traffic classes of outgoing frames, control frames overtake bulk frames that wait to be sent
+enum class SYNAVIS_EXPORT ESendPriority
+{
+  Control = 0u,
+  Bulk
+};
+
+enum class SYNAVIS_EXPORT EBinaryElementType : uint8_t
+{
+  Float32 = 0u,
+  Float64,
+  Int32,
+  UInt32
+};
+
+inline std::size_t BinaryElementSize(EBinaryElementType Type)
+{
+  switch (Type)
+  {
+  case EBinaryElementType::Float64:
+    return sizeof(double);
+  case EBinaryElementType::Float32:
+    return sizeof(float);
+  case EBinaryElementType::Int32:
+    return sizeof(int32_t);
+  case EBinaryElementType::UInt32:
+  default:
+    return sizeof(uint32_t);
+  }
+}
+
+// header that precedes the raw payload of every binary geometry frame
+// the layout is mirrored in the UE plugin (SynavisDrone.cpp), all fields are little endian
+#pragma pack(push, 1)
+struct BinaryGeometryHeader
+{
+  static constexpr uint32_t ExpectedMagic = 0x424E5953u; // "SYNB"
+  uint32_t Magic = ExpectedMagic;
+  char Name[16];       // null-terminated array name, e.g. "points"
+  uint8_t ElementType; // EBinaryElementType
+  uint8_t Reserved;
+  uint16_t TransferId; // echoed as player_id in the answer, 0 if the frame belongs to no transfer
+  uint32_t Count;      // number of elements in this frame
+  uint64_t Offset;     // index of the first element of this frame
+  uint64_t Total;      // number of elements of the whole array
+};
+#pragma pack(pop)
+static_assert(sizeof(BinaryGeometryHeader) == 44, "BinaryGeometryHeader must be packed");
+
+// header in front of every chunk of a resumable buffer transfer, the receiver checks the
+// chunk against its crc32c and reports which chunks it holds intact
+#pragma pack(push, 1)
+struct CheckedChunkHeader
+{
+  static constexpr uint32_t ExpectedMagic = 0x434E5953u; // "SYNC"
+  uint32_t Magic = ExpectedMagic;
+  uint32_t Index;
+  uint32_t Length;     // payload bytes behind the header
+  uint32_t Crc;        // crc32c of the payload
+};
+#pragma pack(pop)
+static_assert(sizeof(CheckedChunkHeader) == 16, "CheckedChunkHeader must be packed");
+
+// header that precedes every fragment of a message that was split up, either by SendData
+// on the data channel or by SendStriped over the stripe channels. The fragment is placed at
+// Sequence * PieceSize of the reassembled message
+#pragma pack(push, 1)
+struct FragmentHeader
+{
+  static constexpr uint32_t ExpectedMagic = 0x464E5953u; // "SYNF"
+  uint32_t Magic = ExpectedMagic;
+  uint32_t MessageId;
+  uint32_t Sequence;
+  uint32_t Count;      // number of fragments of the whole message
+  uint32_t PieceSize;  // payload size of every fragment but the last
+  uint64_t Total;      // size of the whole message in bytes
+};
+#pragma pack(pop)
+static_assert(sizeof(FragmentHeader) == 28, "FragmentHeader must be packed");
+
 class SYNAVIS_EXPORT DataConnector : public std::enable_shared_from_this<DataConnector>
 {
 public:
@@ -26,24 +128,98 @@ public:
   virtual void Initialize();
   void StartSignalling();
 
+  // messages larger than the maximum message size are fragmented and reassembled by a receiving DataConnector
   virtual void SendData(rtc::binary Data);
   void SendString(std::string Message);
-  void SendJSON(json Message);
+  void SendJSON(const json& Message);
+  /**
+   * \brief Hands out a frame from the pool with the UE header already in place.
+   * Write the payload into the frame (and shrink it with SetPayloadSize if needed),
+   * then pass it to SendFrame. The buffer is reused for later frames.
+   * \param PayloadSize number of payload bytes that are reserved
+   */
+  PooledFrame AcquireFrame(std::size_t PayloadSize);
+  bool SendFrame(PooledFrame Frame);
+  /**
+   * \brief Opt-in coalescing of SendJSON calls. Messages are collected into one
+   * {"type":"batch","m":[...]} frame that is sent once it is full or once the first
+   * message in it has waited for DeadlineSeconds. Other sends flush the batch first.
+   * \param Enable
+   * \param DeadlineSeconds
+   */
+  void SetCoalescing(bool Enable, double DeadlineSeconds = 0.002);
+  bool IsCoalescing() const { return Batcher.load() != nullptr; }
+  void FlushBatch();
+  /**
+   * \brief Sends Message as a request and completes with the answer of the peer, which is
+   * found by the id that the request carries as "pid". Any number of requests can be in flight
+   * on one connector. The future fails if the peer answers with an error, if no answer arrives
+   * within TimeoutSeconds (0 uses the time out of the connector) or if the connection is closed.
+   * auto info = connector->Request({{"type","query"},{"object","Sun"}}).get();
+   * \param Message a query, info, parameter or receive message; its pid is replaced
+   * \param TimeoutSeconds
+   */
+  std::future<json> Request(json Message, double TimeoutSeconds = 0.0);
+  // like Request, but Done is called with the answer or the error on the receiving thread
+  void SendRequest(json Message, RequestTracker::Completion Done, double TimeoutSeconds = 0.0);
+  // awaits the answer of a request in a coroutine, which resumes on the receiving thread
+  class SYNAVIS_EXPORT RequestAwaitable
+  {
+  public:
+    RequestAwaitable(DataConnector& inConnector, json inMessage, double inTimeoutSeconds)
+      : Connector(inConnector), Message(std::move(inMessage)), TimeoutSeconds(inTimeoutSeconds) {}
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> Handle);
+    json await_resume();
+  private:
+    DataConnector& Connector;
+    json Message;
+    double TimeoutSeconds;
+    json Answer;
+    std::exception_ptr Error;
+    // set by whichever of await_suspend and the completion comes second resumes the coroutine
+    std::atomic<bool> Completed{ false };
+  };
+  // json info = co_await connector->AwaitRequest({{"type","info"}});
+  RequestAwaitable AwaitRequest(json Message, double TimeoutSeconds = 0.0) { return RequestAwaitable(*this, std::move(Message), TimeoutSeconds); }
+  std::size_t GetPendingRequests() const { return Requests.GetPendingCount(); }
   bool SendBuffer(const std::span<const uint8_t>& Buffer, std::string Name, std::string Format = "raw");
   bool SendFloat64Buffer(const std::vector<double>& Buffer, std::string Name, std::string Format = "raw");
   bool SendFloat32Buffer(const std::vector<float>& Buffer, std::string Name, std::string Format = "raw");
   bool SendInt32Buffer(const std::vector<int32_t>& Buffer, std::string Name, std::string Format = "raw");
+  // sends an array as raw bytes in frames that start with a BinaryGeometryHeader
+  bool SendBinaryArray(std::span<const uint8_t> Buffer, std::string Name, EBinaryElementType Type);
   void SendGeometry(const std::vector<double>& Vertices, const std::vector<uint32_t>& Indices, std::string Name, std::optional<std::vector<double>> Normals = std::nullopt, 
                     std::optional<std::vector<double>> UVs = std::nullopt, std::optional<std::vector<double>> Tangents = std::nullopt, bool AutoMessage = true);
   EConnectionState GetState();
   std::optional<std::function<void(rtc::binary)>> DataReceptionCallback;
   std::optional<std::function<void(std::string)>> MessageReceptionCallback;
+  std::optional<std::function<void(std::span<const std::byte>)>> DataViewCallback;
+  std::optional<std::function<void(std::string_view)>> MessageViewCallback;
   std::optional<std::string> IP {std::nullopt};
   std::optional<std::pair<int, int>> PortRange {std::nullopt};
 
 
   void SetDataCallback(std::function<void(rtc::binary)> Callback);
   void SetMessageCallback(std::function<void(std::string)> Callback);
+  /**
+   * \brief Callbacks that receive views into the received message instead of a copy.
+   * The view is only valid during the call, copy what you need to keep. They are called
+   * before the owning callbacks if both are set. A JsonView over the message reads single
+   * members without parsing all of it.
+   * \param Callback
+   */
+  void SetMessageViewCallback(std::function<void(std::string_view)> Callback) { MessageViewCallback = std::move(Callback); }
+  void SetDataViewCallback(std::function<void(std::span<const std::byte>)> Callback) { DataViewCallback = std::move(Callback); }
+  /**
+   * \brief Incoming frames are dispatched through a table indexed by their first byte.
+   * The handler receives the whole frame, including the type byte, as a view into the
+   * received message that is only valid during the call. An empty handler drops the frame.
+   * \param Type
+   * \param Handler
+   */
+  using FrameHandler = std::function<void(std::span<const std::byte>)>;
+  void SetFrameHandler(uint8_t Type, FrameHandler Handler);
   auto GetMessageCallback() { return MessageReceptionCallback; }
   auto GetDataCallback() { return DataReceptionCallback; }
   std::shared_ptr<rtc::DataChannel> DataChannel;
@@ -56,6 +232,8 @@ public:
   void SetBlock(bool Block){this->Block=Block;}
   bool IsBlocking() const {return this->Block;}
   std::byte DataChannelByte{ 50 };
+  // type of the frames with a uint32 length, these are only sent to peers that announced them
+  std::byte ExtendedDataChannelByte{ 250 };
   void SetOnConnectedCallback(std::function<void(void)> Callback) { OnConnectedCallback = Callback; }
   void SetOnFailedCallback(std::function<void(void)> Callback) { OnFailedCallback = Callback; }
   void SetOnClosedCallback(std::function<void(void)> Callback) { OnClosedCallback = Callback; }
@@ -64,7 +242,17 @@ public:
   void SetOnDataChannelAvailableCallback(std::function<void(void)> Callback) { OnDataChannelAvailableCallback = Callback; }
   void SetRetryOnErrorResponse(bool Retry) { RetryOnErrorResponse = Retry; }
 
-  void LockUntilConnected(unsigned additional_wait = 0);
+  /**
+   * \brief Blocks until the data channel is open.
+   * \param additional_wait milliseconds to sleep after the connection was established
+   * \param timeout seconds after which the wait is given up, wait indefinitely if not positive
+   * \return whether the connection was established
+   */
+  bool LockUntilConnected(unsigned additional_wait = 0, double timeout = -1.0);
+  // blocks until the connection state has reached at least State, returns false on timeout
+  bool WaitForState(EConnectionState State, double TimeOutSeconds = -1.0);
+  // accumulated time that callers spent blocked in waits of this connector
+  const WaitMetric& GetWaitMetric() const { return Waits; }
 
   /**
    * \brief Set the DontWaitForAnswer flag. If set to true, the DataConnector
@@ -81,6 +269,157 @@ public:
    * \param Fail 
    */
   void SetFailIfNotComplete(bool Fail) { FailIfNotComplete = Fail; }
+
+  /**
+   * \brief Buffers sent to a peer that reports the "resumable" capability carry a crc32c
+   * with every chunk. After the chunks are sent, the peer reports which chunks arrived
+   * intact and only the missing ones are sent again, also after a timeout or an error.
+   * Off by default, enabling it asks the peer for its capabilities before the first buffer.
+   * \param Enable
+   * \param Attempts number of times the missing chunks are sent again before giving up
+   */
+  void SetResumableTransfers(bool Enable, std::size_t Attempts = 3)
+  {
+    ResumableTransfers = Enable;
+    ResumeAttempts = Attempts;
+  }
+  /**
+   * \brief Buffers and geometry arrays sent to a peer that reports the "dedup" capability are
+   * remembered by their content hash. An array that the peer already holds is sent as a short
+   * reference instead, and sent in full if the peer no longer has it. SendGeometry sends the
+   * references of all its arrays before it waits for the answers. The peer keeps at most
+   * BudgetBytes for us, the least recently used contents are evicted beyond that.
+   * \param Enable
+   * \param BudgetBytes
+   */
+  void SetDeduplication(bool Enable, std::size_t BudgetBytes = 256 * 1024 * 1024);
+  bool IsDeduplicating() const { return Deduplication; }
+  // forgets all contents here and at the peer, e.g. after the peer was reset
+  void InvalidateContents();
+  // bytes that were sent as references instead of in full
+  uint64_t GetDeduplicatedBytes() const { return DeduplicatedBytes; }
+
+  /**
+   * \brief Sets how many chunks of a buffer transmission may be in flight without
+   * an answer from the peer. With Adaptive set, the window follows the measured
+   * round trip time up to MaxWindow. A window of 1 is the stop-and-wait behavior.
+   * \param MaxWindow
+   * \param Adaptive
+   */
+  void SetTransferWindow(std::size_t MaxWindow, bool Adaptive = true)
+  {
+    MaxTransferWindow = std::max(MaxWindow, static_cast<std::size_t>(1));
+    AdaptiveTransferWindow = Adaptive;
+  }
+  // the window at the end of the last buffer transmission
+  std::size_t GetTransferWindow() const { return LastTransferWindow; }
+
+  /**
+   * \brief Limits the number of bytes that may be queued in the data channel.
+   * Senders are suspended while the queue is above the mark and resume once it
+   * has drained to half of it. A mark of 0 disables the limit.
+   * \param Bytes
+   */
+  void SetSendHighWaterMark(std::size_t Bytes);
+  std::size_t GetSendHighWaterMark() const { return SendHighWaterMark; }
+  /**
+   * \brief Paces all outgoing frames with a token bucket.
+   * \param BytesPerSecond sustained rate, 0 disables pacing
+   * \param BurstBytes bucket size, defaults to a tenth of a second worth of data
+   */
+  void SetPacing(double BytesPerSecond, std::size_t BurstBytes = 0);
+  /**
+   * \brief Bulk frames (buffer chunks and fragments) are held back while a control frame is
+   * queued, including its time in pacing and in front of the high-water mark, and while the
+   * transport holds more than Bytes, so that commands are sent between
+   * the chunks of an upload instead of behind it. A limit of 0 puts all frames into one lane.
+   * \param Bytes
+   */
+  void SetBulkBufferLimit(std::size_t Bytes);
+  std::size_t GetBulkBufferLimit() const { return BulkBufferLimit; }
+  // time that frames of the given class spent between the send call and the transport
+  const WaitMetric& GetLaneLatency(ESendPriority Priority) const { return LaneLatency[static_cast<std::size_t>(Priority)]; }
+
+  /**
+   * \brief Opens Count additional data channels on the peer connection when Initialize
+   * is called. SendStriped spreads the pieces of a large buffer over these channels and the
+   * receiving DataConnector puts them back together by sequence number before the buffer
+   * is handed to the data callback. The Unreal plugin only reads the main data channel,
+   * so striping is meant for transfers between two Synavis endpoints.
+   * \param Count
+   */
+  void SetStripeChannels(std::size_t Count) { StripeChannelCount = Count; }
+  std::size_t GetStripeChannels() const { return StripeChannelCount; }
+  // number of open stripe channels, including the ones that the peer has opened
+  std::size_t GetOpenStripeChannels();
+  bool SendStriped(std::span<const uint8_t> Buffer);
+  /**
+   * \brief Sets after how many seconds without a new fragment a partially received
+   * message is dropped. This applies to fragmented and to striped messages.
+   * \param Seconds
+   */
+  void SetFragmentTimeout(double Seconds);
+  /**
+   * \brief Sets the size of the largest fragmented or striped message that is accepted from
+   * the peer. Its buffer is allocated when the first fragment arrives, 256 MiB by default.
+   * \param Bytes
+   */
+  void SetFragmentLimit(uint64_t Bytes);
+  /**
+   * \brief Sets how many bytes all partially received messages may hold together, 512 MiB by
+   * default for fragmented and for striped messages each. A new message beyond the budget
+   * drops the partial messages that have waited longest for a fragment.
+   * \param Bytes
+   */
+  void SetFragmentBudget(uint64_t Bytes);
+
+  /**
+   * \brief Opens an unordered data channel without retransmissions next to the main channel
+   * when Initialize is called. JSON messages whose type is one of the telemetry types are
+   * sent over it, so that a lost sample never holds back the newer ones behind it. Samples
+   * that find the channel congested are dropped instead of queued. Telemetry that the peer
+   * sends on its own telemetry channel is handled like messages of the main channel.
+   * \param Enable
+   * \param LifetimeMilliseconds retransmit lost samples for this long instead of not at all
+   */
+  void SetTelemetryChannel(bool Enable, unsigned LifetimeMilliseconds = 0);
+  /**
+   * \brief Sets the message types that are routed over the telemetry channel while it is open,
+   * none by default. Only list fire-and-forget samples that may be lost, never subscriptions
+   * such as "track" or requests that expect an answer. The peer has to read its
+   * SynavisTelemetry channel, anything routed there is lost otherwise.
+   * \param Types
+   */
+  void SetTelemetryTypes(std::vector<std::string> Types) { TelemetryTypes = std::move(Types); }
+  const std::vector<std::string>& GetTelemetryTypes() const { return TelemetryTypes; }
+  bool HasTelemetryChannel();
+  // samples that were dropped because the telemetry channel was congested
+  uint64_t GetDroppedTelemetry() const { return DroppedTelemetry; }
+
+  /**
+   * \brief Frames with a 32 bit length let one message use the full message size of the
+   * data channel instead of the 64 KiB that the Unreal frame allows. The support is announced
+   * through the protocol of our data channel, and extended frames are only sent once the peer
+   * has announced it as well, so legacy peers keep receiving Unreal frames. Set before Initialize.
+   * \param Enable
+   */
+  void SetExtendedFraming(bool Enable) { ExtendedFraming = Enable; }
+  bool UsesExtendedFrames() const { return ExtendedFraming && PeerSupportsExtendedFrames; }
+  // number of payload bytes that fit into one frame with the negotiated framing
+  std::size_t GetMaxFramePayload() const;
+
+  /**
+   * \brief Sets how SendGeometry transmits arrays that do not fit into a single message.
+   * Automatic asks the peer once whether it understands binary geometry frames.
+   * \param Transfer
+   */
+  void SetGeometryTransfer(EGeometryTransfer Transfer) { GeometryTransfer = Transfer; }
+  EGeometryTransfer GetGeometryTransfer() const { return GeometryTransfer; }
+  bool QueryBinaryGeometrySupport();
+  // asks the peer once for the features it supports, peers that do not answer support none.
+  // Concurrent callers wait for the one query that is in flight
+  std::vector<std::string> QueryPeerCapabilities();
+  bool PeerSupports(std::string_view Capability);
   void CommunicateSDPs();
   void WriteSDPsToFile(std::string Filename);
   void SetLogVerbosity(ELogVerbosity Verbosity) { LogVerbosity = Verbosity; }
@@ -89,11 +428,35 @@ public:
   void SetIPForICE(std::string IP) { rtcconfig_.bindAddress = IP; }
   void SetPortRangeForICE(uint16_t Min, uint16_t Max) { rtcconfig_.portRangeBegin = Min; rtcconfig_.portRangeBegin = Max; }
 
+  /**
+   * \brief Handlers for inbound messages by type, see MessageRouter. Messages that a handler
+   * took do not reach the message callbacks, the others do.
+   * auto handle = connector->GetRouter().Route("track", [](const JsonView& Message) { ... });
+   */
+  MessageRouter& GetRouter() { return Router; }
+  /**
+   * \brief Mirrors the properties that the peer pushes with its track messages, so that
+   * reads do not cost a round trip while the values are fresh. Track messages still reach
+   * the router and the message callbacks.
+   * connector->SetSceneCache(true); connector->GetScene().Track("Sun", "Rotation");
+   * auto rotation = connector->GetScene().Read("Sun", "Rotation", 0.1);
+   */
+  void SetSceneCache(bool Enable) { Scene.SetEnabled(Enable); }
+  SceneState& GetScene() { return Scene; }
+  /**
+   * \brief Keeps the numeric values of the last Capacity track messages in columns, see
+   * TrackHistory. A capacity of 0 stops recording, histories that were handed out stay valid.
+   * \param Capacity number of track messages that are kept
+   */
+  std::shared_ptr<TrackHistory> SetTrackHistory(std::size_t Capacity);
+  std::shared_ptr<TrackHistory> GetTrackHistory() const { return History.load(); }
+
   /**
    * brief Sets a message callback that is called when a message is received.
    * This is experimental with the intention to replace the MessageReceptionCallback
    * \param Callback
    */
+  [[deprecated("route messages by type with GetRouter().Route")]]
   void exp__PushMessageCallback(auto Callback) { exp__OnMessagecallbacks.push_back(Callback); }
   void exp__ClearMessageCallbacks() { exp__OnMessagecallbacks.clear(); }
   void exp__ActivateCallbacks()
@@ -123,10 +486,113 @@ protected:
   std::deque<std::function<void(std::string)>> exp__OnMessagecallbacks;
 
   inline void DataChannelMessageHandling(rtc::message_variant Data);
+  void RegisterFrameHandlers();
+  void HandleTextFrame(std::span<const std::byte> Frame);
+  void HandleExtendedFrame(std::span<const std::byte> Frame);
+  // passes data that is not a message to the view callback and a copy to the data callback
+  void DeliverData(std::span<const std::byte> Data);
+  std::array<FrameHandler, 256> FrameHandlers;
+  MessageRouter Router;
+  // requests that wait for their answer, see Request
+  RequestTracker Requests;
+  SceneState Scene{ *this };
+  std::atomic<std::shared_ptr<TrackHistory>> History;
+
+  // every outgoing frame passes through here to honor the high-water mark and the pacing
+  bool Transmit(const rtc::binary& Frame, ESendPriority Priority = ESendPriority::Control);
+  bool Transmit(rtc::DataChannel& Channel, const rtc::binary& Frame, ESendPriority Priority = ESendPriority::Control);
+  // onBufferedAmountLow has to fire for the high-water mark and for the bulk lane
+  std::size_t GetBufferedAmountLowThreshold() const
+  {
+    return (BulkBufferLimit > 0) ? std::min(SendHighWaterMark / 2, BulkBufferLimit) : SendHighWaterMark / 2;
+  }
+  // splits Message into fragments of at most MaxFrameSize bytes, each is sent on the channel that SelectChannel returns
+  bool TransmitFragments(std::span<const std::byte> Message, std::size_t MaxFrameSize,
+    const std::function<rtc::DataChannel&()>& SelectChannel);
+  // returns false if Data does not start with a FragmentHeader
+  bool InsertFragment(MessageAssembler& Assembler, const rtc::binary& Data);
+  // CapabilityMutex must be held, the reference is valid for as long as it is
+  const std::vector<std::string>& QueryPeerCapabilitiesLocked();
+
+  // a buffer transmission in flight, the answers of the peer are dispatched to it by its id
+  struct Transfer
+  {
+    uint16_t Id{ 0 };
+    std::atomic<std::size_t> Acknowledged{ 0 };
+    std::atomic<bool> Failed{ false };
+    std::mutex Mutex;
+    std::condition_variable Condition;
+    // called under Mutex for every answer that is not an error
+    std::function<void(const JsonView&)> OnAcknowledgement;
+  };
+  std::shared_ptr<Transfer> OpenTransfer();
+  void CloseTransfer(const std::shared_ptr<Transfer>& Current);
+  // returns true if the message was an answer that belongs to a transfer
+  bool DispatchTransferMessage(const JsonView& Message);
+  bool HasActiveTransfers();
+  // a reference that was sent without waiting for the answer, the buffer must outlive it
+  struct DeferredReference
+  {
+    std::future<json> Answer;
+    std::span<const uint8_t> Buffer;
+    std::string Name;
+    std::string Kind;
+    uint64_t Hash{ 0 };
+    std::function<bool(void)> Upload;
+  };
+  // sends Buffer by reference if the peer holds it, otherwise through Upload and lets the peer keep it.
+  // Kind names the representation on the wire, the format of a buffer or the element type of an array.
+  // With Deferred the answer to a reference is not awaited but left for ResolveReferences
+  bool SendDeduplicated(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Kind, const std::function<bool(void)>& Upload,
+    std::vector<DeferredReference>* Deferred = nullptr);
+  // waits for the answers to the deferred references and uploads the arrays the peer could not resolve
+  bool ResolveReferences(std::vector<DeferredReference>& Deferred);
+  // true if the peer placed the referenced content, otherwise the content is forgotten
+  bool AwaitReference(std::future<json>& Answer, uint64_t Hash, std::size_t Size, const std::string& Name);
+  bool UploadAndKeep(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Kind, uint64_t Hash, const std::function<bool(void)>& Upload);
+  bool TransmitBuffer(std::span<const uint8_t> Buffer, const std::string& Name, const std::string& Format);
+  bool TransmitBinaryArray(std::span<const uint8_t> Buffer, const std::string& Name, EBinaryElementType Type);
+  // passes a received message to the transfers or to the message callback
+  void HandleMessage(std::string_view Message);
+
+  // sends Chunks frames whose payload is produced by WriteChunk, with at most the transfer window
+  // of them waiting for an answer. The start and stop messages carry the transfer id as pid
+  bool TransmitChunks(std::size_t Chunks, std::size_t ChunkSize, const std::function<std::size_t(std::size_t, uint8_t*)>& WriteChunk,
+    std::optional<json> StartMessage, std::optional<json> StopMessage, std::shared_ptr<Transfer> Current = nullptr);
+  // like TransmitChunks, but every chunk is checked by the peer and the missing chunks are sent again
+  bool TransmitResumable(std::size_t Chunks, std::size_t ChunkSize, const std::function<std::size_t(std::size_t, uint8_t*)>& WriteChunk,
+    json StartMessage, json StopMessage);
+  // the chunks of the transfer that the peer holds intact, one bit per chunk
+  std::optional<std::vector<uint8_t>> QueryChunkBitmap(const std::shared_ptr<Transfer>& Current, const std::string& Name);
+
+  void AddStripeChannel(std::shared_ptr<rtc::DataChannel> Channel);
+  void StripeMessageHandling(rtc::message_variant Data);
+  void AddTelemetryChannel(std::shared_ptr<rtc::DataChannel> Channel);
+  // sends the message over the telemetry channel, false if it has to take the main channel
+  bool TransmitTelemetry(const json& Message);
 
   ELogVerbosity LogVerbosity = ELogVerbosity::Warning;
 
-  EConnectionState state_;
+  void SetState(EConnectionState State);
+  std::atomic<EConnectionState> state_;
+  std::mutex StateMutex;
+  std::condition_variable StateCondition;
+  WaitMetric Waits;
+  FramePool Frames;
+  // replaced by SetCoalescing while senders use it
+  std::atomic<std::shared_ptr<MessageBatcher>> Batcher;
+  std::size_t SendHighWaterMark{ 8 * 1024 * 1024 };
+  std::mutex BufferMutex;
+  std::condition_variable BufferCondition;
+  std::size_t BulkBufferLimit{ 1024 * 1024 };
+  // control frames between their send call and the transport, guarded by BufferMutex
+  std::size_t ControlQueued{ 0 };
+  std::array<WaitMetric, 2> LaneLatency;
+  std::mutex PacingMutex;
+  double PacingRate{ 0.0 };
+  std::size_t PacingBurst{ 0 };
+  double PacingTokens{ 0.0 };
+  WaitMetric::clock::time_point PacingRefill;
 
   rtc::Configuration rtcconfig_;
   rtc::Configuration webconfig_;
@@ -142,6 +608,44 @@ protected:
   double TimeOut = 10.0;
   unsigned int MessagesReceived{ 0 };
   std::size_t MaxMessageSize{ static_cast<std::size_t>(-1) };
+  EGeometryTransfer GeometryTransfer = EGeometryTransfer::Automatic;
+  std::size_t MaxTransferWindow{ 16 };
+  static constexpr std::size_t InitialTransferWindow{ 4 };
+  std::size_t LastTransferWindow{ 1 };
+  bool AdaptiveTransferWindow = true;
+  std::mutex CapabilityMutex;
+  std::optional<std::vector<std::string>> PeerCapabilities;
+  bool ResumableTransfers = false;
+  bool Deduplication = false;
+  ContentCache Contents;
+  // the peer is told to drop what it kept from an earlier connection before the first upload
+  std::atomic<bool> ContentsSynchronized{ false };
+  std::atomic<uint64_t> DeduplicatedBytes{ 0 };
+  std::size_t ResumeAttempts{ 3 };
+  std::mutex TransferMutex;
+  std::unordered_map<uint16_t, std::shared_ptr<Transfer>> Transfers;
+  uint16_t NextTransferId{ 1 };
+  // the Unreal plugin receives one buffer without frame headers at a time
+  std::mutex BufferTransferMutex;
+  static constexpr std::string_view ExtendedFramingProtocol = "synavis-ext32";
+  bool ExtendedFraming = true;
+  std::atomic<bool> PeerSupportsExtendedFrames{ false };
+  static constexpr std::string_view StripeChannelLabel = "SynavisStripe";
+  std::size_t StripeChannelCount{ 0 };
+  std::mutex StripeMutex;
+  std::vector<std::shared_ptr<rtc::DataChannel>> StripeChannels;
+  static constexpr std::string_view TelemetryChannelLabel = "SynavisTelemetry";
+  // a sample that waits behind this much data is already stale
+  static constexpr std::size_t TelemetryBufferLimit{ 64 * 1024 };
+  bool TelemetryChannel = false;
+  unsigned TelemetryLifetime{ 0 };
+  std::vector<std::string> TelemetryTypes;
+  std::mutex TelemetryMutex;
+  std::vector<std::shared_ptr<rtc::DataChannel>> TelemetryChannels;
+  std::atomic<uint64_t> DroppedTelemetry{ 0 };
+  std::atomic<uint32_t> NextFragmentId{ 0 };
+  MessageAssembler StripeAssembler;
+  MessageAssembler FragmentAssembler;
   std::vector<std::string> RequiredCandidate;
   json config_{
     {"SignallingIP", int()},
@@ -0,0 +1,114 @@
+#include "FramePool.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+struct Synavis::PooledFrame::Storage
+{
+  std::mutex Access;
+  std::vector<rtc::binary> Idle;
+  std::size_t MaxPooled;
+  std::size_t Allocations{ 0 };
+};
+
+Synavis::PooledFrame::PooledFrame(std::shared_ptr<Storage> inOrigin, rtc::binary&& inBuffer, std::size_t inHeader)
+  : Origin(std::move(inOrigin)), Buffer(std::move(inBuffer)), Header(inHeader)
+{
+}
+
+Synavis::PooledFrame::PooledFrame(PooledFrame&& Other) noexcept
+  : Origin(std::move(Other.Origin)), Buffer(std::move(Other.Buffer)), Header(Other.Header)
+{
+  Other.Buffer.clear();
+}
+
+Synavis::PooledFrame& Synavis::PooledFrame::operator=(PooledFrame&& Other) noexcept
+{
+  if (this != &Other)
+  {
+    Release();
+    Origin = std::move(Other.Origin);
+    Buffer = std::move(Other.Buffer);
+    Header = Other.Header;
+    Other.Buffer.clear();
+  }
+  return *this;
+}
+
+Synavis::PooledFrame::~PooledFrame()
+{
+  Release();
+}
+
+void Synavis::PooledFrame::SetPayloadSize(std::size_t Size)
+{
+  if (Size > (IsExtended() ? std::numeric_limits<uint32_t>::max() : std::numeric_limits<uint16_t>::max()))
+  {
+    throw std::runtime_error("Frame payload exceeds the length field");
+  }
+  Buffer.resize(Size + Header + 1);
+  if (IsExtended())
+  {
+    const auto length = static_cast<uint32_t>(Size);
+    std::memcpy(Buffer.data() + 1, &length, sizeof(length));
+  }
+  else
+  {
+    const auto length = static_cast<uint16_t>(Size);
+    std::memcpy(Buffer.data() + 1, &length, sizeof(length));
+  }
+  Buffer.back() = std::byte(0);
+}
+
+void Synavis::PooledFrame::Release()
+{
+  if (!Origin || Buffer.capacity() == 0)
+    return;
+  std::lock_guard<std::mutex> lock(Origin->Access);
+  if (Origin->Idle.size() < Origin->MaxPooled)
+  {
+    Origin->Idle.push_back(std::move(Buffer));
+  }
+  Buffer = rtc::binary();
+  Origin.reset();
+}
+
+Synavis::FramePool::FramePool(std::size_t MaxPooled)
+  : Buffers(std::make_shared<PooledFrame::Storage>())
+{
+  Buffers->MaxPooled = MaxPooled;
+}
+
+Synavis::PooledFrame Synavis::FramePool::Acquire(std::byte Type, std::size_t PayloadSize, bool Extended)
+{
+  rtc::binary buffer;
+  {
+    std::lock_guard<std::mutex> lock(Buffers->Access);
+    if (!Buffers->Idle.empty())
+    {
+      buffer = std::move(Buffers->Idle.back());
+      Buffers->Idle.pop_back();
+    }
+    else
+    {
+      Buffers->Allocations++;
+    }
+  }
+  PooledFrame frame(Buffers, std::move(buffer), Extended ? PooledFrame::ExtendedHeaderSize : PooledFrame::HeaderSize);
+  frame.SetPayloadSize(PayloadSize);
+  frame.Buffer[0] = Type;
+  return frame;
+}
+
+std::size_t Synavis::FramePool::GetAllocationCount() const
+{
+  std::lock_guard<std::mutex> lock(Buffers->Access);
+  return Buffers->Allocations;
+}
+
+std::size_t Synavis::FramePool::GetIdleCount() const
+{
+  std::lock_guard<std::mutex> lock(Buffers->Access);
+  return Buffers->Idle.size();
+}
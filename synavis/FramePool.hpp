@@ -0,0 +1,78 @@
+#pragma once
+#ifndef SYNAVIS_FRAMEPOOL_HPP
+#define SYNAVIS_FRAMEPOOL_HPP
+#include <rtc/rtc.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // an outgoing data channel frame that is handed out by a FramePool
+  // the layout is [type byte][uint16 payload length][payload][null], the header space
+  // is reserved up front so that callers can write the payload into its final place.
+  // Extended frames carry a uint32 length instead, for peers that negotiated them
+  // the buffer returns to its pool when the frame is destroyed
+  class SYNAVIS_EXPORT PooledFrame
+  {
+  public:
+    static constexpr std::size_t HeaderSize = 3;
+    static constexpr std::size_t ExtendedHeaderSize = 5;
+    static constexpr std::size_t Overhead = HeaderSize + 1;
+    static constexpr std::size_t ExtendedOverhead = ExtendedHeaderSize + 1;
+
+    PooledFrame() = default;
+    PooledFrame(const PooledFrame&) = delete;
+    PooledFrame& operator=(const PooledFrame&) = delete;
+    PooledFrame(PooledFrame&& Other) noexcept;
+    PooledFrame& operator=(PooledFrame&& Other) noexcept;
+    ~PooledFrame();
+
+    // the writable payload area behind the header
+    std::span<std::byte> Payload() { return { Buffer.data() + Header, PayloadSize() }; }
+    uint8_t* PayloadData() { return reinterpret_cast<uint8_t*>(Buffer.data() + Header); }
+    std::size_t PayloadSize() const { return Buffer.size() - Header - 1; }
+    // shrinks or grows the payload and updates the length field and the terminator
+    void SetPayloadSize(std::size_t Size);
+    // incremental writing for payloads of unknown length: BeginAppend drops the payload,
+    // Append adds to it and EndAppend updates the length field and the terminator
+    void BeginAppend() { Buffer.resize(Header); }
+    void Append(const char* Data, std::size_t Length)
+    {
+      const auto* bytes = reinterpret_cast<const std::byte*>(Data);
+      Buffer.insert(Buffer.end(), bytes, bytes + Length);
+    }
+    void Append(char Character) { Buffer.push_back(static_cast<std::byte>(Character)); }
+    void EndAppend() { SetPayloadSize(Buffer.size() - Header); }
+    // the complete frame as it is put on the wire
+    const rtc::binary& Data() const { return Buffer; }
+    bool IsValid() const { return !Buffer.empty(); }
+    bool IsExtended() const { return Header == ExtendedHeaderSize; }
+
+  private:
+    friend class FramePool;
+    struct Storage;
+    PooledFrame(std::shared_ptr<Storage> inOrigin, rtc::binary&& inBuffer, std::size_t inHeader);
+    void Release();
+    std::shared_ptr<Storage> Origin;
+    rtc::binary Buffer;
+    std::size_t Header{ HeaderSize };
+  };
+
+  // keeps the buffers of sent frames around so that their allocations are reused
+  class SYNAVIS_EXPORT FramePool
+  {
+  public:
+    // MaxPooled is the number of idle buffers that are kept, further buffers are freed
+    explicit FramePool(std::size_t MaxPooled = 32);
+    PooledFrame Acquire(std::byte Type, std::size_t PayloadSize, bool Extended = false);
+    // number of buffers that had to be allocated because the pool was empty
+    std::size_t GetAllocationCount() const;
+    std::size_t GetIdleCount() const;
+  private:
+    std::shared_ptr<PooledFrame::Storage> Buffers;
+  };
+}
+#endif
@@ -0,0 +1,195 @@
+#include "JsonView.hpp"
+
+namespace
+{
+  constexpr auto npos = std::string_view::npos;
+
+  std::size_t SkipWhitespace(std::string_view Text, std::size_t Position)
+  {
+    while (Position < Text.size() && (Text[Position] == ' ' || Text[Position] == '\n' || Text[Position] == '\r' || Text[Position] == '\t'))
+      ++Position;
+    return Position;
+  }
+
+  // Position is at the opening quote, returns the position behind the closing quote
+  std::size_t SkipString(std::string_view Text, std::size_t Position)
+  {
+    for (std::size_t search = Position + 1;;)
+    {
+      const auto quote = Text.find('"', search);
+      if (quote == npos)
+        return npos;
+      // a quote behind an odd number of backslashes is part of the string
+      std::size_t backslashes = 0;
+      while (quote - backslashes > Position + 1 && Text[quote - backslashes - 1] == '\\')
+        ++backslashes;
+      if (backslashes % 2 == 0)
+        return quote + 1;
+      search = quote + 1;
+    }
+  }
+
+  // returns the position behind the value that starts at Position
+  std::size_t SkipValue(std::string_view Text, std::size_t Position)
+  {
+    if (Position >= Text.size())
+      return npos;
+    const char first = Text[Position];
+    if (first == '"')
+      return SkipString(Text, Position);
+    if (first == '{' || first == '[')
+    {
+      std::size_t depth = 0;
+      for (std::size_t search = Position;;)
+      {
+        search = Text.find_first_of("\"{}[]", search);
+        if (search == npos)
+          return npos;
+        const char c = Text[search];
+        if (c == '"')
+        {
+          search = SkipString(Text, search);
+          if (search == npos)
+            return npos;
+          continue;
+        }
+        depth += (c == '{' || c == '[') ? 1 : -1;
+        ++search;
+        if (depth == 0)
+          return search;
+      }
+    }
+    // numbers and literals end at the next delimiter
+    const auto end = Text.find_first_of(",}] \t\r\n", Position);
+    if (end == Position)
+      return npos;
+    return end == npos ? Text.size() : end;
+  }
+}
+
+Synavis::JsonView::JsonView(std::string_view inText)
+  : Source(inText)
+{
+}
+
+bool Synavis::JsonView::IsObject() const
+{
+  const auto first = SkipWhitespace(Source, 0);
+  return first < Source.size() && Source[first] == '{';
+}
+
+bool Synavis::JsonView::NextMember(std::size_t& Position, std::string_view& Key, std::string_view& Value) const
+{
+  const auto fail = [&Position]() { Position = npos; return false; };
+  // behind the closing brace the position is one past the text, a text that ends without it is truncated
+  if (Position == npos || Position > Source.size())
+    return false;
+  if (Position == 0)
+  {
+    Position = SkipWhitespace(Source, 0);
+    if (Position >= Source.size() || Source[Position] != '{')
+      return fail();
+    Position = SkipWhitespace(Source, Position + 1);
+  }
+  else
+  {
+    // behind the previous value there is either the next member or the end of the object
+    Position = SkipWhitespace(Source, Position);
+    if (Position >= Source.size())
+      return fail();
+    if (Source[Position] == ',')
+      Position = SkipWhitespace(Source, Position + 1);
+    else if (Source[Position] != '}')
+      return fail();
+  }
+  if (Position < Source.size() && Source[Position] == '}')
+  {
+    Position = Source.size() + 1;
+    return false;
+  }
+  if (Position >= Source.size() || Source[Position] != '"')
+    return fail();
+  const auto key_end = SkipString(Source, Position);
+  if (key_end == npos)
+    return fail();
+  Key = Source.substr(Position + 1, key_end - Position - 2);
+  Position = SkipWhitespace(Source, key_end);
+  if (Position >= Source.size() || Source[Position] != ':')
+    return fail();
+  Position = SkipWhitespace(Source, Position + 1);
+  const auto value_end = SkipValue(Source, Position);
+  if (value_end == npos)
+    return fail();
+  Value = Source.substr(Position, value_end - Position);
+  Position = value_end;
+  return true;
+}
+
+std::string_view Synavis::JsonView::Type() const
+{
+  if (!TypeValue.has_value())
+  {
+    // the frame chunks of the plugin name their type "t" to keep them short
+    std::optional<std::string_view> type, short_type;
+    std::size_t position = 0;
+    std::string_view key, value;
+    while (!type.has_value() && NextMember(position, key, value))
+    {
+      if (value.size() < 2 || value.front() != '"')
+        continue;
+      if (key == "type")
+        type = value.substr(1, value.size() - 2);
+      else if (key == "t" && !short_type.has_value())
+        short_type = value.substr(1, value.size() - 2);
+    }
+    TypeValue = type.value_or(short_type.value_or(std::string_view()));
+  }
+  return TypeValue.value();
+}
+
+std::optional<std::string_view> Synavis::JsonView::Raw(std::string_view Key) const
+{
+  std::size_t position = 0;
+  std::string_view key, value;
+  while (NextMember(position, key, value))
+  {
+    if (key == Key)
+      return value;
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string_view> Synavis::JsonView::String(std::string_view Key) const
+{
+  const auto raw = Raw(Key);
+  if (!raw.has_value() || raw->size() < 2 || raw->front() != '"')
+    return std::nullopt;
+  return raw->substr(1, raw->size() - 2);
+}
+
+std::optional<bool> Synavis::JsonView::Bool(std::string_view Key) const
+{
+  const auto raw = Raw(Key);
+  if (raw == "true")
+    return true;
+  if (raw == "false")
+    return false;
+  return std::nullopt;
+}
+
+std::optional<Synavis::JsonView> Synavis::JsonView::Object(std::string_view Key) const
+{
+  const auto raw = Raw(Key);
+  if (!raw.has_value() || raw->front() != '{')
+    return std::nullopt;
+  return JsonView(raw.value());
+}
+
+const Synavis::JsonView::json& Synavis::JsonView::Tree() const
+{
+  if (!Parsed)
+  {
+    Parsed = std::make_shared<const json>(json::parse(Source, nullptr, false));
+  }
+  return *Parsed;
+}
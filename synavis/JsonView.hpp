@@ -0,0 +1,79 @@
+#pragma once
+#ifndef SYNAVIS_JSONVIEW_HPP
+#define SYNAVIS_JSONVIEW_HPP
+#include <json.hpp>
+#include <charconv>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // read-only access to the members of a json object without building the tree. The type of
+  // the message ("type", or "t" for the frame chunks of the Unreal plugin) is looked up first
+  // and further members are found by skipping over the top-level values when they are asked
+  // for, so a large base64 member that is not needed costs no more than a scan for its quotes.
+  // The view points into the message text, which must outlive it. Tree parses the whole
+  // message with nlohmann for the consumers that need it
+  class SYNAVIS_EXPORT JsonView
+  {
+  public:
+    using json = nlohmann::json;
+    JsonView() = default;
+    explicit JsonView(std::string_view inText);
+
+    std::string_view Text() const { return Source; }
+    bool IsObject() const;
+    // the value of the type member, empty if there is none
+    std::string_view Type() const;
+
+    // the text of the value of the top-level member Key, e.g. "12.5", "\"points\"" or "{...}"
+    std::optional<std::string_view> Raw(std::string_view Key) const;
+    bool Contains(std::string_view Key) const { return Raw(Key).has_value(); }
+    // the content of a string member without its quotes. Escape sequences are not resolved,
+    // which is exact for the names and base64 that Unreal sends, use Tree for free text
+    std::optional<std::string_view> String(std::string_view Key) const;
+    std::optional<bool> Bool(std::string_view Key) const;
+    std::optional<JsonView> Object(std::string_view Key) const;
+    template < typename T >
+    std::optional<T> Number(std::string_view Key) const
+    {
+      static_assert(std::is_arithmetic_v<T>, "Number reads integral and floating point members");
+      const auto raw = Raw(Key);
+      if (!raw.has_value())
+        return std::nullopt;
+      T value{};
+      const auto [end, error] = std::from_chars(raw->data(), raw->data() + raw->size(), value);
+      if (error != std::errc() || end != raw->data() + raw->size())
+        return std::nullopt;
+      return value;
+    }
+    // calls Function(Key, Raw) for every top-level member, e.g. for track messages whose
+    // members are named after the tracked properties. Returns false if the text is malformed
+    // or truncated, the members ahead of the damage are passed to Function nonetheless
+    template < typename F >
+    bool ForEachMember(F&& Function) const
+    {
+      std::size_t position = 0;
+      std::string_view key, value;
+      while (NextMember(position, key, value))
+        Function(key, value);
+      return position != std::string_view::npos;
+    }
+
+    // the whole message parsed with nlohmann, a discarded value if it is not valid json.
+    // The tree is parsed on the first call and kept
+    const json& Tree() const;
+
+  private:
+    // advances Position to the next member, Position is one past the text behind the closing brace and npos on an error
+    bool NextMember(std::size_t& Position, std::string_view& Key, std::string_view& Value) const;
+    std::string_view Source;
+    mutable std::optional<std::string_view> TypeValue;
+    // shared so that copies of the view stay cheap and see the same tree
+    mutable std::shared_ptr<const json> Parsed;
+  };
+}
+#endif
@@ -155,19 +155,19 @@ void Synavis::MediaReceiver::SendMouseClick()
   rtc::binary m_down = { 72_b, 0_b, 0_b, 0_b, 0_b, 0_b };
   rtc::binary m_up = { 73_b, 0_b, 0_b, 0_b, 0_b, 0_b };
 
-  DataChannel->send(m_down);
+  Transmit(m_down);
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
-  DataChannel->send(m_up);
+  Transmit(m_up);
 }
 
 void Synavis::MediaReceiver::StartStreaming()
 {
-  DataChannel->send(rtc::binary({ 4_b }));
+  Transmit(rtc::binary({ 4_b }));
 }
 
 void Synavis::MediaReceiver::StopStreaming()
 {
-  DataChannel->send(rtc::binary({ 5_b }));
+  Transmit(rtc::binary({ 5_b }));
 }
 
 void Synavis::MediaReceiver::MediaHandler(rtc::message_variant DataOrMessage)
@@ -0,0 +1,145 @@
+#include "MessageAssembler.hpp"
+#include <algorithm>
+#include <cstring>
+
+Synavis::MessageAssembler::MessageAssembler(std::function<void(rtc::binary)> inDeliver, clock::duration inStaleTimeout)
+  : Deliver(std::move(inDeliver)), StaleTimeout(inStaleTimeout), LastSweep(clock::now())
+{
+}
+
+bool Synavis::MessageAssembler::Insert(uint32_t MessageId, uint32_t Sequence, uint32_t Count, uint32_t PieceSize,
+  uint64_t Total, std::span<const std::byte> Piece)
+{
+  if (Count == 0 || Sequence >= Count || PieceSize == 0)
+    return false;
+  // the header comes from the wire, Total has to be what Count pieces of PieceSize make up
+  const uint64_t offset = static_cast<uint64_t>(Sequence) * PieceSize;
+  const uint64_t last_offset = static_cast<uint64_t>(Count - 1) * PieceSize;
+  // a single empty piece is the only message without bytes
+  const bool empty = (Count == 1 && Total == 0);
+  if ((Total <= last_offset && !empty) || Total > last_offset + PieceSize)
+    return false;
+  const uint64_t expected = (Sequence + 1 == Count) ? Total - last_offset : PieceSize;
+  if (Piece.size() != expected)
+    return false;
+  rtc::binary complete;
+  {
+    const auto now = clock::now();
+    std::lock_guard<std::mutex> lock(Access);
+    if (Total > MaxTotal || Total > MaxPendingBytes)
+      return false;
+    // a sweep at most every half timeout keeps the cost of an insert constant
+    if (now - LastSweep > StaleTimeout / 2)
+    {
+      DiscardStaleLocked(now);
+    }
+    if (!Partials.contains(MessageId))
+    {
+      // the buffer is committed in full before its first byte arrives
+      EvictLocked(Total);
+    }
+    auto [it, inserted] = Partials.try_emplace(MessageId);
+    Partial& partial = it->second;
+    if (inserted)
+    {
+      partial.Buffer.resize(Total);
+      PendingBytes += Total;
+      partial.Received.assign(Count, false);
+      partial.Missing = Count;
+      partial.PieceSize = PieceSize;
+    }
+    else if (partial.Received.size() != Count || partial.Buffer.size() != Total || partial.PieceSize != PieceSize)
+    {
+      return false;
+    }
+    partial.LastUpdate = now;
+    if (partial.Received[Sequence])
+      return true;
+    if (!Piece.empty())
+      std::memcpy(partial.Buffer.data() + offset, Piece.data(), Piece.size());
+    partial.Received[Sequence] = true;
+    if (--partial.Missing > 0)
+      return true;
+    PendingBytes -= partial.Buffer.size();
+    complete = std::move(partial.Buffer);
+    Partials.erase(it);
+    Delivered++;
+  }
+  // the callback runs without the lock so that it may send or insert again
+  Deliver(std::move(complete));
+  return true;
+}
+
+std::size_t Synavis::MessageAssembler::DiscardStale()
+{
+  std::lock_guard<std::mutex> lock(Access);
+  return DiscardStaleLocked(clock::now());
+}
+
+void Synavis::MessageAssembler::SetStaleTimeout(clock::duration inStaleTimeout)
+{
+  std::lock_guard<std::mutex> lock(Access);
+  StaleTimeout = inStaleTimeout;
+}
+
+void Synavis::MessageAssembler::SetMaxTotal(uint64_t inMaxTotal)
+{
+  std::lock_guard<std::mutex> lock(Access);
+  MaxTotal = inMaxTotal;
+}
+
+uint64_t Synavis::MessageAssembler::GetMaxTotal() const
+{
+  std::lock_guard<std::mutex> lock(Access);
+  return MaxTotal;
+}
+
+void Synavis::MessageAssembler::SetMaxPendingBytes(uint64_t inMaxPendingBytes)
+{
+  std::lock_guard<std::mutex> lock(Access);
+  MaxPendingBytes = inMaxPendingBytes;
+  EvictLocked(0);
+}
+
+uint64_t Synavis::MessageAssembler::GetMaxPendingBytes() const
+{
+  std::lock_guard<std::mutex> lock(Access);
+  return MaxPendingBytes;
+}
+
+uint64_t Synavis::MessageAssembler::GetPendingBytes() const
+{
+  std::lock_guard<std::mutex> lock(Access);
+  return PendingBytes;
+}
+
+void Synavis::MessageAssembler::EvictLocked(uint64_t Incoming)
+{
+  while (!Partials.empty() && PendingBytes + Incoming > MaxPendingBytes)
+  {
+    const auto oldest = std::ranges::min_element(Partials, {}, [](const auto& Entry) { return Entry.second.LastUpdate; });
+    PendingBytes -= oldest->second.Buffer.size();
+    Partials.erase(oldest);
+    Discarded++;
+  }
+}
+
+std::size_t Synavis::MessageAssembler::DiscardStaleLocked(clock::time_point Now)
+{
+  LastSweep = Now;
+  const auto dropped = std::erase_if(Partials, [this, Now](const auto& Entry)
+    {
+      if (Now - Entry.second.LastUpdate <= StaleTimeout)
+        return false;
+      PendingBytes -= Entry.second.Buffer.size();
+      return true;
+    });
+  Discarded += dropped;
+  return dropped;
+}
+
+std::size_t Synavis::MessageAssembler::GetPendingCount() const
+{
+  std::lock_guard<std::mutex> lock(Access);
+  return Partials.size();
+}
@@ -0,0 +1,78 @@
+#pragma once
+#ifndef SYNAVIS_MESSAGEASSEMBLER_HPP
+#define SYNAVIS_MESSAGEASSEMBLER_HPP
+#include <rtc/rtc.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // puts the pieces of a message back together that arrive out of order, e.g. because they
+  // were striped over several data channels. Every message is written into one buffer that
+  // is allocated with its final size when the first piece arrives, and it is handed to the
+  // delivery function exactly once when the last missing piece has been inserted.
+  // Messages that have not received a piece for the stale timeout are dropped, and so are the
+  // least recently updated ones when the buffers of all partial messages exceed the budget
+  class SYNAVIS_EXPORT MessageAssembler
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+    explicit MessageAssembler(std::function<void(rtc::binary)> inDeliver,
+      clock::duration inStaleTimeout = std::chrono::seconds(10));
+    MessageAssembler(const MessageAssembler&) = delete;
+    MessageAssembler& operator=(const MessageAssembler&) = delete;
+
+    // inserts piece Sequence of Count pieces of message MessageId. The piece is placed at
+    // Sequence * PieceSize of a message with Total bytes. Every piece but the last one has
+    // exactly PieceSize bytes, the last one holds the rest of Total. Returns false if the
+    // piece does not fit the message or Total exceeds the limit, duplicates are ignored
+    bool Insert(uint32_t MessageId, uint32_t Sequence, uint32_t Count, uint32_t PieceSize,
+      uint64_t Total, std::span<const std::byte> Piece);
+
+    // drops the messages that have not made progress for the stale timeout, this also
+    // happens during Insert. Returns the number of dropped messages
+    std::size_t DiscardStale();
+    void SetStaleTimeout(clock::duration inStaleTimeout);
+    // the largest message that is accepted, its buffer is allocated with the first piece
+    void SetMaxTotal(uint64_t inMaxTotal);
+    uint64_t GetMaxTotal() const;
+    // the bytes that all partial messages may hold together, a smaller budget evicts right away
+    void SetMaxPendingBytes(uint64_t inMaxPendingBytes);
+    uint64_t GetMaxPendingBytes() const;
+    uint64_t GetPendingBytes() const;
+
+    std::size_t GetPendingCount() const;
+    uint64_t GetDeliveredCount() const { return Delivered; }
+    uint64_t GetDiscardedCount() const { return Discarded; }
+
+  private:
+    struct Partial
+    {
+      rtc::binary Buffer;
+      std::vector<bool> Received;
+      uint32_t Missing{ 0 };
+      uint32_t PieceSize{ 0 };
+      clock::time_point LastUpdate;
+    };
+    std::size_t DiscardStaleLocked(clock::time_point Now);
+    // drops the least recently updated messages until Incoming more bytes fit into the budget
+    void EvictLocked(uint64_t Incoming);
+    std::function<void(rtc::binary)> Deliver;
+    clock::duration StaleTimeout;
+    uint64_t MaxTotal{ 256ull * 1024 * 1024 };
+    uint64_t MaxPendingBytes{ 512ull * 1024 * 1024 };
+    uint64_t PendingBytes{ 0 };
+    clock::time_point LastSweep;
+    mutable std::mutex Access;
+    std::unordered_map<uint32_t, Partial> Partials;
+    uint64_t Delivered{ 0 };
+    uint64_t Discarded{ 0 };
+  };
+}
+#endif
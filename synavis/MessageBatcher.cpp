@@ -0,0 +1,154 @@
+#include "MessageBatcher.hpp"
+#include "Synavis.hpp"
+
+static const Synavis::Logger::LoggerInstance lbatcher = Synavis::Logger::Get()->LogStarter("MessageBatcher");
+
+Synavis::MessageBatcher::MessageBatcher(std::function<void(std::string_view)> inFlushFunction, std::size_t inMaxPayload, clock::duration inDeadline)
+  : FlushFunction(std::move(inFlushFunction)), MaxPayload(inMaxPayload), Deadline(inDeadline)
+{
+  Pending.reserve(MaxPayload);
+  Pending = EnvelopeBegin;
+  Outgoing.reserve(MaxPayload);
+  Timer = std::async(std::launch::async, &MessageBatcher::Run, this);
+}
+
+Synavis::MessageBatcher::~MessageBatcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(Access);
+    Running = false;
+  }
+  Wake.notify_all();
+  Timer.wait();
+  try
+  {
+    Flush();
+  }
+  catch (const std::exception& e)
+  {
+    lbatcher(Synavis::ELogVerbosity::Error) << "Dropping the last batch: " << e.what() << std::endl;
+  }
+}
+
+void Synavis::MessageBatcher::Add(std::string_view Message)
+{
+  std::unique_lock<std::mutex> lock(Access);
+  Messages++;
+  const std::size_t overhead = EnvelopeBegin.size() + EnvelopeEnd.size();
+  // messages that cannot share an envelope go out on their own, behind everything pending
+  if (Message.size() + overhead > MaxPayload)
+  {
+    std::unique_lock<std::mutex> sending(Sending);
+    const std::size_t taken = TakePending();
+    Flushes++;
+    lock.unlock();
+    DeliverOutgoing(taken);
+    FlushFunction(Message);
+    return;
+  }
+  std::unique_lock<std::mutex> sending(Sending, std::defer_lock);
+  std::size_t taken = 0;
+  if (Pending.size() + 1 + Message.size() + EnvelopeEnd.size() > MaxPayload)
+  {
+    sending.lock();
+    taken = TakePending();
+  }
+  if (PendingCount > 0)
+  {
+    Pending += ',';
+  }
+  else
+  {
+    FirstPending = clock::now();
+  }
+  Pending.append(Message);
+  PendingCount++;
+  const bool first = (PendingCount == 1);
+  lock.unlock();
+  if (first)
+  {
+    Wake.notify_all();
+  }
+  if (sending.owns_lock())
+  {
+    DeliverOutgoing(taken);
+  }
+}
+
+void Synavis::MessageBatcher::Flush()
+{
+  std::unique_lock<std::mutex> lock(Access);
+  std::lock_guard<std::mutex> sending(Sending);
+  const std::size_t taken = TakePending();
+  lock.unlock();
+  DeliverOutgoing(taken);
+}
+
+void Synavis::MessageBatcher::SetMaxPayload(std::size_t inMaxPayload)
+{
+  std::unique_lock<std::mutex> lock(Access);
+  const bool shrinks = (inMaxPayload < MaxPayload);
+  MaxPayload = inMaxPayload;
+  if (!shrinks)
+    return;
+  std::lock_guard<std::mutex> sending(Sending);
+  const std::size_t taken = TakePending();
+  lock.unlock();
+  DeliverOutgoing(taken);
+}
+
+std::size_t Synavis::MessageBatcher::TakePending()
+{
+  const std::size_t count = PendingCount;
+  if (count == 0)
+    return 0;
+  // the buffers trade places, so that neither of them has to allocate again
+  std::swap(Pending, Outgoing);
+  Pending.assign(EnvelopeBegin);
+  PendingCount = 0;
+  Flushes++;
+  return count;
+}
+
+void Synavis::MessageBatcher::DeliverOutgoing(std::size_t Count)
+{
+  if (Count == 1)
+  {
+    FlushFunction(std::string_view(Outgoing).substr(EnvelopeBegin.size()));
+  }
+  else if (Count > 1)
+  {
+    Outgoing.append(EnvelopeEnd);
+    FlushFunction(Outgoing);
+  }
+}
+
+void Synavis::MessageBatcher::Run()
+{
+  std::unique_lock<std::mutex> lock(Access);
+  while (Running)
+  {
+    Wake.wait(lock, [this]() { return !Running || PendingCount > 0; });
+    if (!Running)
+      break;
+    // the envelope might be flushed by size in the meantime, in which case the deadline starts anew
+    const auto deadline = FirstPending + Deadline;
+    if (!Wake.wait_until(lock, deadline, [this, deadline]() { return !Running || PendingCount == 0 || FirstPending + Deadline != deadline; }))
+    {
+      std::unique_lock<std::mutex> sending(Sending);
+      const std::size_t taken = TakePending();
+      lock.unlock();
+      // a send that fails, e.g. on a closed channel, must not end the timer
+      try
+      {
+        DeliverOutgoing(taken);
+      }
+      catch (const std::exception& e)
+      {
+        lbatcher(Synavis::ELogVerbosity::Error) << "Dropping a batch of " << taken << " messages: " << e.what() << std::endl;
+      }
+      sending.unlock();
+      lock.lock();
+    }
+  }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#ifndef SYNAVIS_MESSAGEBATCHER_HPP
+#define SYNAVIS_MESSAGEBATCHER_HPP
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // collects small json messages into one envelope of the form {"type":"batch","m":[...]}
+  // the envelope is handed to the flush function once it would exceed the payload size
+  // or once the oldest message in it has waited for the deadline
+  class SYNAVIS_EXPORT MessageBatcher
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+    static constexpr std::string_view EnvelopeBegin = "{\"type\":\"batch\",\"m\":[";
+    static constexpr std::string_view EnvelopeEnd = "]}";
+
+    MessageBatcher(std::function<void(std::string_view)> inFlushFunction, std::size_t inMaxPayload, clock::duration inDeadline);
+    ~MessageBatcher();
+    MessageBatcher(const MessageBatcher&) = delete;
+    MessageBatcher& operator=(const MessageBatcher&) = delete;
+
+    // Message must be a serialized json object
+    void Add(std::string_view Message);
+    // sends everything that is pending, a single pending message is sent without envelope
+    void Flush();
+    void SetMaxPayload(std::size_t inMaxPayload);
+
+    uint64_t GetMessageCount() const { return Messages; }
+    uint64_t GetFlushCount() const { return Flushes; }
+
+  private:
+    // moves the envelope into Outgoing and returns the number of messages in it. Access and
+    // Sending must be held, Sending stays held until the payload is delivered, so payloads
+    // reach the flush function in the order they were taken even though Access is released
+    std::size_t TakePending();
+    void DeliverOutgoing(std::size_t Count);
+    void Run();
+    std::function<void(std::string_view)> FlushFunction;
+    std::size_t MaxPayload;
+    clock::duration Deadline;
+    std::mutex Access;
+    std::mutex Sending;
+    std::condition_variable Wake;
+    std::string Pending;
+    std::string Outgoing;
+    std::size_t PendingCount{ 0 };
+    clock::time_point FirstPending;
+    bool Running = true;
+    uint64_t Messages{ 0 };
+    uint64_t Flushes{ 0 };
+    std::future<void> Timer;
+  };
+}
+#endif
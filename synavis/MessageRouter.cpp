@@ -0,0 +1,206 @@
+#include "MessageRouter.hpp"
+#include "Synavis.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+  struct StringHash
+  {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view Text) const noexcept { return std::hash<std::string_view>{}(Text); }
+  };
+  // looked up with the string_views of the message, without building a string
+  template < typename T >
+  using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+  struct Entry
+  {
+    uint64_t Id;
+    Synavis::MessageRouter::Handler Function;
+    std::optional<Synavis::MessageRouter::Executor> Run;
+  };
+  struct FieldRoute
+  {
+    std::string Field;
+    StringMap<std::vector<Entry>> Values;
+  };
+  struct TypeRoute
+  {
+    std::vector<Entry> Any;
+    std::vector<FieldRoute> Fields;
+  };
+  using Table = StringMap<TypeRoute>;
+}
+
+// registrations replace the table, so a dispatch works on a snapshot that is not changed under it
+struct Synavis::MessageRouter::State
+{
+  std::mutex Mutex;
+  std::shared_ptr<const Table> Current = std::make_shared<const Table>();
+  uint64_t NextId{ 1 };
+
+  void Remove(uint64_t Id)
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    auto table = std::make_shared<Table>(*Current);
+    const auto matches = [Id](const Entry& Candidate) { return Candidate.Id == Id; };
+    for (auto type = table->begin(); type != table->end();)
+    {
+      std::erase_if(type->second.Any, matches);
+      for (auto& field : type->second.Fields)
+      {
+        for (auto& [value, entries] : field.Values)
+          std::erase_if(entries, matches);
+        std::erase_if(field.Values, [](const auto& Value) { return Value.second.empty(); });
+      }
+      std::erase_if(type->second.Fields, [](const FieldRoute& Field) { return Field.Values.empty(); });
+      if (type->second.Any.empty() && type->second.Fields.empty())
+        type = table->erase(type);
+      else
+        ++type;
+    }
+    Current = std::move(table);
+  }
+};
+
+Synavis::MessageRouter::Executor Synavis::MessageRouter::RunOn(WorkerThread& Worker)
+{
+  return [&Worker](std::function<void(void)>&& Task) { Worker.AddTask(std::move(Task)); };
+}
+
+Synavis::MessageRouter::Registration::Registration(std::weak_ptr<State> inRouter, uint64_t inId)
+  : Router(std::move(inRouter)), Id(inId)
+{
+}
+
+Synavis::MessageRouter::Registration::Registration(Registration&& Other) noexcept
+  : Router(std::move(Other.Router)), Id(Other.Id)
+{
+  Other.Id = 0;
+}
+
+Synavis::MessageRouter::Registration& Synavis::MessageRouter::Registration::operator=(Registration&& Other) noexcept
+{
+  if (this != &Other)
+  {
+    Release();
+    Router = std::move(Other.Router);
+    Id = Other.Id;
+    Other.Id = 0;
+  }
+  return *this;
+}
+
+Synavis::MessageRouter::Registration::~Registration()
+{
+  Release();
+}
+
+void Synavis::MessageRouter::Registration::Release()
+{
+  if (Id == 0)
+    return;
+  // the router may be gone already, then there is nothing to remove
+  if (auto router = Router.lock())
+    router->Remove(Id);
+  Router.reset();
+  Id = 0;
+}
+
+bool Synavis::MessageRouter::Registration::IsActive() const
+{
+  return Id != 0 && !Router.expired();
+}
+
+Synavis::MessageRouter::MessageRouter()
+  : Shared(std::make_shared<State>())
+{
+}
+
+Synavis::MessageRouter::Registration Synavis::MessageRouter::Route(std::string Type, Handler Function, std::optional<Executor> Run)
+{
+  return Add(std::move(Type), std::nullopt, std::move(Function), std::move(Run));
+}
+
+Synavis::MessageRouter::Registration Synavis::MessageRouter::Route(std::string Type, std::string Field, std::string Value,
+  Handler Function, std::optional<Executor> Run)
+{
+  return Add(std::move(Type), std::make_pair(std::move(Field), std::move(Value)), std::move(Function), std::move(Run));
+}
+
+Synavis::MessageRouter::Registration Synavis::MessageRouter::Add(std::string Type,
+  std::optional<std::pair<std::string, std::string>> Field, Handler Function, std::optional<Executor> Run)
+{
+  std::lock_guard<std::mutex> lock(Shared->Mutex);
+  auto table = std::make_shared<Table>(*Shared->Current);
+  const uint64_t id = Shared->NextId++;
+  auto& route = (*table)[std::move(Type)];
+  if (Field.has_value())
+  {
+    auto field = std::ranges::find(route.Fields, Field->first, &FieldRoute::Field);
+    if (field == route.Fields.end())
+      field = route.Fields.insert(route.Fields.end(), FieldRoute{ Field->first, {} });
+    field->Values[std::move(Field->second)].push_back(Entry{ id, std::move(Function), std::move(Run) });
+  }
+  else
+  {
+    route.Any.push_back(Entry{ id, std::move(Function), std::move(Run) });
+  }
+  Shared->Current = std::move(table);
+  return Registration(Shared, id);
+}
+
+bool Synavis::MessageRouter::Dispatch(const JsonView& Message) const
+{
+  std::shared_ptr<const Table> table;
+  {
+    std::lock_guard<std::mutex> lock(Shared->Mutex);
+    table = Shared->Current;
+  }
+  if (table->empty())
+    return false;
+  const auto route = table->find(Message.Type());
+  if (route == table->end())
+    return false;
+  bool handled = false;
+  std::shared_ptr<const std::string> copy;
+  const auto invoke = [&](const Entry& Target)
+    {
+      handled = true;
+      if (!Target.Run.has_value())
+      {
+        Target.Function(Message);
+        return;
+      }
+      if (!copy)
+        copy = std::make_shared<const std::string>(Message.Text());
+      // the snapshot keeps the handler alive until the task has run
+      Target.Run.value()([table, function = &Target.Function, copy]() { (*function)(JsonView(*copy)); });
+    };
+  for (const auto& field : route->second.Fields)
+  {
+    auto value = Message.String(field.Field);
+    if (!value.has_value())
+      value = Message.Raw(field.Field);
+    if (!value.has_value())
+      continue;
+    if (const auto entries = field.Values.find(value.value()); entries != field.Values.end())
+    {
+      for (const auto& entry : entries->second)
+        invoke(entry);
+    }
+  }
+  for (const auto& entry : route->second.Any)
+    invoke(entry);
+  return handled;
+}
+
+bool Synavis::MessageRouter::IsEmpty() const
+{
+  std::lock_guard<std::mutex> lock(Shared->Mutex);
+  return Shared->Current->empty();
+}
@@ -0,0 +1,69 @@
+#pragma once
+#ifndef SYNAVIS_MESSAGEROUTER_HPP
+#define SYNAVIS_MESSAGEROUTER_HPP
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include "JsonView.hpp"
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  class WorkerThread;
+
+  // hands inbound messages to the handlers that are registered for their type, and optionally
+  // for the value of one further member such as "name". The handlers of a message are found
+  // by one hash lookup instead of asking every handler in turn. A handler stays registered as
+  // long as the Registration that Route returned is alive. Handlers without executor run on the
+  // receiving thread and get a view into the received message; handlers with an executor get
+  // a view into their own copy, since the message is gone by the time they run
+  class SYNAVIS_EXPORT MessageRouter
+  {
+    struct State;
+  public:
+    using Handler = std::function<void(const JsonView&)>;
+    using Executor = std::function<void(std::function<void(void)>&&)>;
+    // an executor that queues the handler on the worker thread
+    static Executor RunOn(WorkerThread& Worker);
+
+    class SYNAVIS_EXPORT Registration
+    {
+    public:
+      Registration() = default;
+      Registration(Registration&& Other) noexcept;
+      Registration& operator=(Registration&& Other) noexcept;
+      Registration(const Registration&) = delete;
+      Registration& operator=(const Registration&) = delete;
+      ~Registration();
+      // removes the handler, a message that is being dispatched may still reach it
+      void Release();
+      bool IsActive() const;
+    private:
+      friend class MessageRouter;
+      Registration(std::weak_ptr<State> inRouter, uint64_t inId);
+      std::weak_ptr<State> Router;
+      uint64_t Id{ 0 };
+    };
+
+    MessageRouter();
+    MessageRouter(const MessageRouter&) = delete;
+    MessageRouter& operator=(const MessageRouter&) = delete;
+
+    [[nodiscard]] Registration Route(std::string Type, Handler Function, std::optional<Executor> Run = std::nullopt);
+    // only messages whose member Field has the value Value, e.g. Route("query", "name", "spawn", ...)
+    [[nodiscard]] Registration Route(std::string Type, std::string Field, std::string Value, Handler Function,
+      std::optional<Executor> Run = std::nullopt);
+
+    // returns whether a handler took the message
+    bool Dispatch(const JsonView& Message) const;
+    bool IsEmpty() const;
+
+  private:
+    Registration Add(std::string Type, std::optional<std::pair<std::string, std::string>> Field,
+      Handler Function, std::optional<Executor> Run);
+    std::shared_ptr<State> Shared;
+  };
+}
+#endif
@@ -136,17 +136,14 @@ bool Synavis::Provider::EstablishedConnection(bool Shallow)
   }
   else
   {
-    int PingSuccessful = -1;
-    std::chrono::system_clock::time_point precheck = std::chrono::system_clock::now();
+    // the task can outlive this call if the wait times out, so it must not refer to our stack
+    auto PingSuccessful = std::make_shared<std::promise<bool>>();
+    auto Result = PingSuccessful->get_future();
     std::cout << Prefix() << "Sending the request to wait for ping" << std::endl;
-    CreateTask([this,&PingSuccessful]
+    CreateTask([this,PingSuccessful]
       {
         int reception{0};
         reception = BridgeConnection.In->Receive();
-        // while((reception = BridgeConnection.In->Peek()) == 0)
-        // {
-        //   std::this_thread::yield();
-        // }
         try
         {
           std::cout << Prefix() << "Received something that might be a ping:" << std::endl;
@@ -155,24 +152,21 @@ bool Synavis::Provider::EstablishedConnection(bool Shallow)
           {
             std::cout << Prefix() << "Sending pong!" << std::endl;
             BridgeConnection.Out->Send(json({{"ping",int(1)}}).dump());
-            PingSuccessful = 1;
+            PingSuccessful->set_value(true);
+          }
+          else
+          {
+            PingSuccessful->set_value(false);
           }
         }catch(...)
         {
-          PingSuccessful = 0;
+          PingSuccessful->set_value(false);
         }
       });
-    while(PingSuccessful == -1)
-    {
-      std::chrono::system_clock::time_point sysnow = std::chrono::system_clock::now();
-      auto orig_diff = sysnow - precheck;
-      auto diff = std::chrono::duration_cast<std::chrono::seconds>(orig_diff);
-      if(diff < Timeout || TimeoutPolicy < EMessageTimeoutPolicy::Critical)
-        std::this_thread::yield();
-      else
-        break;
-    }
-    return PingSuccessful == 1;
+    std::optional<WaitMetric::clock::time_point> deadline;
+    if(TimeoutPolicy >= EMessageTimeoutPolicy::Critical)
+      deadline = WaitMetric::clock::now() + Timeout;
+    return Waits.Wait(Result, deadline) && Result.get();
   }
 }
 
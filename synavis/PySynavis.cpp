@@ -185,6 +185,26 @@ namespace Synavis
       .export_values()
     ;
 
+    py::class_<WaitMetric>(m, "WaitMetric")
+      .def("GetSeconds", &WaitMetric::GetSeconds)
+      .def("GetLongestSeconds", &WaitMetric::GetLongestSeconds)
+      .def("GetCount", &WaitMetric::GetCount)
+      .def("Reset", &WaitMetric::Reset)
+    ;
+
+    py::enum_<EGeometryTransfer>(m, "GeometryTransfer")
+      .value("Automatic", EGeometryTransfer::Automatic)
+      .value("Base64", EGeometryTransfer::Base64)
+      .value("Binary", EGeometryTransfer::Binary)
+      .export_values()
+    ;
+
+    py::enum_<ESendPriority>(m, "SendPriority")
+      .value("Control", ESendPriority::Control)
+      .value("Bulk", ESendPriority::Bulk)
+      .export_values()
+    ;
+
     
     py::class_<UnrealReceiver, PyReceiver, std::shared_ptr<UnrealReceiver>>(m, "UnrealReceiver")
       .def(py::init<>())
@@ -244,6 +264,66 @@ namespace Synavis
       .def("GetTaskCount", &WorkerThread::GetTaskCount)
     ;
 
+    py::class_<MessageRouter::Registration>(m, "RouteRegistration")
+      .def("Release", &MessageRouter::Registration::Release)
+      .def("IsActive", &MessageRouter::Registration::IsActive);
+
+    // the columns are numpy views into the ring without a copy, they keep the history alive and come
+    // with the number of rows written when they were taken. The rows are in time order as long as
+    // GetWritten() returns the same number, Copy takes a snapshot
+    const auto column_array = [](const TrackHistory::ColumnView& View, py::handle Owner)
+      {
+        std::vector<py::ssize_t> shape{ static_cast<py::ssize_t>(View.Rows) };
+        std::vector<py::ssize_t> strides{ static_cast<py::ssize_t>(View.Width * sizeof(double)) };
+        if (View.Width > 1)
+        {
+          shape.push_back(static_cast<py::ssize_t>(View.Width));
+          strides.push_back(sizeof(double));
+        }
+        py::array_t<double> result(shape, strides, View.Data, Owner);
+        // the ring belongs to the receiving thread
+        result.attr("setflags")(py::arg("write") = false);
+        return py::make_tuple(result, View.Written);
+      };
+    py::class_<TrackHistory, std::shared_ptr<TrackHistory>>(m, "TrackHistory")
+      .def(py::init<std::size_t>(), py::arg("Capacity"))
+      .def("Column", [column_array](py::object Self, const std::string& Property) -> py::object
+        {
+          const auto view = Self.cast<TrackHistory&>().View(Property);
+          if (!view.has_value())
+            return py::none();
+          return column_array(view.value(), Self);
+        }, py::arg("Property"))
+      .def("Copy", [](const TrackHistory& Self, const std::string& Property) -> py::object
+        {
+          std::vector<double> values;
+          std::size_t width = 1;
+          if (!Self.Copy(Property, values, width))
+            return py::none();
+          py::array_t<double> result({ static_cast<py::ssize_t>(values.size() / width), static_cast<py::ssize_t>(width) });
+          std::copy(values.begin(), values.end(), result.mutable_data());
+          return width > 1 ? py::object(result) : py::object(result.attr("reshape")(-1));
+        }, py::arg("Property"))
+      .def("Times", [column_array](py::object Self) { return column_array(Self.cast<TrackHistory&>().Times(), Self); })
+      .def("RemoteTimes", [column_array](py::object Self) { return column_array(Self.cast<TrackHistory&>().RemoteTimes(), Self); })
+      .def("Update", [](TrackHistory& Self, const std::string& Message) { Self.Update(JsonView(Message)); }, py::arg("Message"))
+      .def("Clear", &TrackHistory::Clear)
+      .def("Size", &TrackHistory::Size)
+      .def("GetCapacity", &TrackHistory::GetCapacity)
+      .def("GetWritten", &TrackHistory::GetWritten)
+      .def("GetProperties", &TrackHistory::GetProperties);
+
+    py::class_<SceneState>(m, "SceneState")
+      .def("Track", &SceneState::Track, py::arg("Object"), py::arg("Property"))
+      .def("Untrack", &SceneState::Untrack, py::arg("Object"), py::arg("Property"))
+      .def("GetFresh", &SceneState::GetFresh, py::arg("Object"), py::arg("Property"), py::arg("MaxAgeSeconds"))
+      .def("Read", &SceneState::Read, py::arg("Object"), py::arg("Property"), py::arg("MaxAgeSeconds"), py::arg("TimeoutSeconds") = 0.0,
+        py::call_guard<py::gil_scoped_release>())
+      .def("Clear", &SceneState::Clear)
+      .def("Size", &SceneState::Size)
+      .def("GetCacheHits", &SceneState::GetCacheHits)
+      .def("GetRemoteReads", &SceneState::GetRemoteReads);
+
     py::class_<DataConnector, PyDataConnector<>, std::shared_ptr<DataConnector>>(m, "DataConnector")
       .def(py::init<>())
       .def("Initialize", &DataConnector::Initialize)
@@ -253,6 +333,38 @@ namespace Synavis
       .def("SetOnRemoteDescriptionCallback", &DataConnector::SetOnRemoteDescriptionCallback, py::arg("Callback"))
       .def("SetDataCallback", &DataConnector::SetDataCallback,py::arg("Callback"))
       .def("SetMessageCallback", &DataConnector::SetMessageCallback,py::arg("Callback"))
+      // python handlers receive the parsed message, the registration must be kept to stay routed
+      .def("Route", [](DataConnector& Self, std::string Type, std::function<void(nlohmann::json)> Handler)
+        {
+          return Self.GetRouter().Route(std::move(Type), [Handler](const JsonView& Message) { Handler(Message.Tree()); });
+        }, py::arg("Type"), py::arg("Handler"))
+      .def("RouteField", [](DataConnector& Self, std::string Type, std::string Field, std::string Value, std::function<void(nlohmann::json)> Handler)
+        {
+          return Self.GetRouter().Route(std::move(Type), std::move(Field), std::move(Value), [Handler](const JsonView& Message) { Handler(Message.Tree()); });
+        }, py::arg("Type"), py::arg("Field"), py::arg("Value"), py::arg("Handler"))
+      // blocks until the answer arrives, errors and time outs are raised as exceptions
+      .def("Request", [](DataConnector& Self, nlohmann::json Message, double TimeoutSeconds)
+        {
+          return Self.Request(std::move(Message), TimeoutSeconds).get();
+        }, py::arg("Message"), py::arg("TimeoutSeconds") = 0.0, py::call_guard<py::gil_scoped_release>())
+      // Callback(answer, error) with a None answer and the error text if the request failed
+      .def("SendRequest", [](DataConnector& Self, nlohmann::json Message, std::function<void(nlohmann::json, std::optional<std::string>)> Callback, double TimeoutSeconds)
+        {
+          Self.SendRequest(std::move(Message), [Callback](nlohmann::json Answer, std::exception_ptr Error)
+            {
+              std::optional<std::string> reason;
+              try
+              {
+                if (Error)
+                  std::rethrow_exception(Error);
+              }
+              catch (const std::exception& e)
+              {
+                reason = e.what();
+              }
+              Callback(std::move(Answer), std::move(reason));
+            }, TimeoutSeconds);
+        }, py::arg("Message"), py::arg("Callback"), py::arg("TimeoutSeconds") = 0.0)
       .def("SetOnDataChannelAvailableCallback", &DataConnector::SetOnDataChannelAvailableCallback,py::arg("Callback"))
       .def("SetConfig", &DataConnector::SetConfig,py::arg("Config"))
       .def("SetConfigFile", &DataConnector::SetConfigFile,py::arg("ConfigFile"))
@@ -273,10 +385,50 @@ namespace Synavis
       .def("WriteSDPsToFile", &DataConnector::WriteSDPsToFile, py::arg("Filename"))
       .def("SetTimeOut", &DataConnector::SetTimeOut, py::arg("TimeOut"))
       .def("SetFailIfNotComplete", &DataConnector::SetFailIfNotComplete, py::arg("FailIfNotComplete"))
+      .def("SetResumableTransfers", &DataConnector::SetResumableTransfers, py::arg("Enable"), py::arg("Attempts") = 3)
+      .def("SetDeduplication", &DataConnector::SetDeduplication, py::arg("Enable"), py::arg("BudgetBytes") = 256 * 1024 * 1024)
+      .def("IsDeduplicating", &DataConnector::IsDeduplicating)
+      .def("InvalidateContents", &DataConnector::InvalidateContents)
+      .def("GetDeduplicatedBytes", &DataConnector::GetDeduplicatedBytes)
+      .def("QueryPeerCapabilities", &DataConnector::QueryPeerCapabilities)
+      .def("SetSceneCache", &DataConnector::SetSceneCache, py::arg("Enable"))
+      .def("GetScene", &DataConnector::GetScene, py::return_value_policy::reference_internal)
+      .def("SetTrackHistory", &DataConnector::SetTrackHistory, py::arg("Capacity"))
+      .def("GetTrackHistory", &DataConnector::GetTrackHistory)
+      .def("SetGeometryTransfer", &DataConnector::SetGeometryTransfer, py::arg("Transfer"))
+      .def("GetGeometryTransfer", &DataConnector::GetGeometryTransfer)
+      .def("SetTransferWindow", &DataConnector::SetTransferWindow, py::arg("MaxWindow"), py::arg("Adaptive") = true)
+      .def("GetTransferWindow", &DataConnector::GetTransferWindow)
+      .def("SetSendHighWaterMark", &DataConnector::SetSendHighWaterMark, py::arg("Bytes"))
+      .def("GetSendHighWaterMark", &DataConnector::GetSendHighWaterMark)
+      .def("SetPacing", &DataConnector::SetPacing, py::arg("BytesPerSecond"), py::arg("BurstBytes") = 0)
+      .def("SetBulkBufferLimit", &DataConnector::SetBulkBufferLimit, py::arg("Bytes"))
+      .def("GetBulkBufferLimit", &DataConnector::GetBulkBufferLimit)
+      .def("GetLaneLatency", &DataConnector::GetLaneLatency, py::arg("Priority"), py::return_value_policy::reference_internal)
+      .def("SetCoalescing", &DataConnector::SetCoalescing, py::arg("Enable"), py::arg("DeadlineSeconds") = 0.002)
+      .def("IsCoalescing", &DataConnector::IsCoalescing)
+      .def("FlushBatch", &DataConnector::FlushBatch)
+      .def("SetStripeChannels", &DataConnector::SetStripeChannels, py::arg("Count"))
+      .def("GetStripeChannels", &DataConnector::GetStripeChannels)
+      .def("GetOpenStripeChannels", &DataConnector::GetOpenStripeChannels)
+      .def("SendStriped", &DataConnector::SendStriped, py::arg("Buffer"))
+      .def("SetFragmentTimeout", &DataConnector::SetFragmentTimeout, py::arg("Seconds"))
+      .def("SetFragmentLimit", &DataConnector::SetFragmentLimit, py::arg("Bytes"))
+      .def("SetFragmentBudget", &DataConnector::SetFragmentBudget, py::arg("Bytes"))
+      .def("SetTelemetryChannel", &DataConnector::SetTelemetryChannel, py::arg("Enable"), py::arg("LifetimeMilliseconds") = 0)
+      .def("SetTelemetryTypes", &DataConnector::SetTelemetryTypes, py::arg("Types"))
+      .def("GetTelemetryTypes", &DataConnector::GetTelemetryTypes)
+      .def("HasTelemetryChannel", &DataConnector::HasTelemetryChannel)
+      .def("GetDroppedTelemetry", &DataConnector::GetDroppedTelemetry)
+      .def("SetExtendedFraming", &DataConnector::SetExtendedFraming, py::arg("Enable"))
+      .def("UsesExtendedFrames", &DataConnector::UsesExtendedFrames)
+      .def("GetMaxFramePayload", &DataConnector::GetMaxFramePayload)
       .def("SetDontWaitForAnswer", &DataConnector::SetDontWaitForAnswer, py::arg("DontWaitForAnswer"))
       .def_readwrite("IP", &DataConnector::IP)
       .def_readwrite("PortRange", &DataConnector::IP)
-      .def("LockUntilConnected", &DataConnector::LockUntilConnected, py::arg("additional_wait") = 0)
+      .def("LockUntilConnected", &DataConnector::LockUntilConnected, py::arg("additional_wait") = 0, py::arg("timeout") = -1.0)
+      .def("WaitForState", &DataConnector::WaitForState, py::arg("State"), py::arg("TimeOut") = -1.0)
+      .def("GetWaitMetric", &DataConnector::GetWaitMetric, py::return_value_policy::reference_internal)
     ;
 
     py::class_<MediaReceiver, PyMediaReceiver<>, std::shared_ptr<MediaReceiver>>(m, "MediaReceiver")
@@ -291,6 +443,38 @@ namespace Synavis
       .def("SendJSON", &MediaReceiver::SendJSON, py::arg("Message"))
       .def("SetDataCallback", &MediaReceiver::SetDataCallback, py::arg("Callback"))
       .def("SetMessageCallback", &MediaReceiver::SetMessageCallback, py::arg("Callback"))
+      // python handlers receive the parsed message, the registration must be kept to stay routed
+      .def("Route", [](MediaReceiver& Self, std::string Type, std::function<void(nlohmann::json)> Handler)
+        {
+          return Self.GetRouter().Route(std::move(Type), [Handler](const JsonView& Message) { Handler(Message.Tree()); });
+        }, py::arg("Type"), py::arg("Handler"))
+      .def("RouteField", [](MediaReceiver& Self, std::string Type, std::string Field, std::string Value, std::function<void(nlohmann::json)> Handler)
+        {
+          return Self.GetRouter().Route(std::move(Type), std::move(Field), std::move(Value), [Handler](const JsonView& Message) { Handler(Message.Tree()); });
+        }, py::arg("Type"), py::arg("Field"), py::arg("Value"), py::arg("Handler"))
+      // blocks until the answer arrives, errors and time outs are raised as exceptions
+      .def("Request", [](MediaReceiver& Self, nlohmann::json Message, double TimeoutSeconds)
+        {
+          return Self.Request(std::move(Message), TimeoutSeconds).get();
+        }, py::arg("Message"), py::arg("TimeoutSeconds") = 0.0, py::call_guard<py::gil_scoped_release>())
+      // Callback(answer, error) with a None answer and the error text if the request failed
+      .def("SendRequest", [](MediaReceiver& Self, nlohmann::json Message, std::function<void(nlohmann::json, std::optional<std::string>)> Callback, double TimeoutSeconds)
+        {
+          Self.SendRequest(std::move(Message), [Callback](nlohmann::json Answer, std::exception_ptr Error)
+            {
+              std::optional<std::string> reason;
+              try
+              {
+                if (Error)
+                  std::rethrow_exception(Error);
+              }
+              catch (const std::exception& e)
+              {
+                reason = e.what();
+              }
+              Callback(std::move(Answer), std::move(reason));
+            }, TimeoutSeconds);
+        }, py::arg("Message"), py::arg("Callback"), py::arg("TimeoutSeconds") = 0.0)
       .def("SetConfig", &MediaReceiver::SetConfig, py::arg("Config"))
       .def("SetConfigFile", &MediaReceiver::SetConfigFile, py::arg("ConfigFile"))
       .def("StartSignalling", &MediaReceiver::StartSignalling)
@@ -312,10 +496,50 @@ namespace Synavis
       .def("SetCodec", &MediaReceiver::SetCodec, py::arg("Codec"))
       .def("SetTimeOut", &MediaReceiver::SetTimeOut, py::arg("TimeOut"))
       .def("SetFailIfNotComplete", &MediaReceiver::SetFailIfNotComplete, py::arg("FailIfNotComplete"))
+      .def("SetResumableTransfers", &MediaReceiver::SetResumableTransfers, py::arg("Enable"), py::arg("Attempts") = 3)
+      .def("SetDeduplication", &MediaReceiver::SetDeduplication, py::arg("Enable"), py::arg("BudgetBytes") = 256 * 1024 * 1024)
+      .def("IsDeduplicating", &MediaReceiver::IsDeduplicating)
+      .def("InvalidateContents", &MediaReceiver::InvalidateContents)
+      .def("GetDeduplicatedBytes", &MediaReceiver::GetDeduplicatedBytes)
+      .def("QueryPeerCapabilities", &MediaReceiver::QueryPeerCapabilities)
+      .def("SetSceneCache", &MediaReceiver::SetSceneCache, py::arg("Enable"))
+      .def("GetScene", &MediaReceiver::GetScene, py::return_value_policy::reference_internal)
+      .def("SetTrackHistory", &MediaReceiver::SetTrackHistory, py::arg("Capacity"))
+      .def("GetTrackHistory", &MediaReceiver::GetTrackHistory)
+      .def("SetGeometryTransfer", &MediaReceiver::SetGeometryTransfer, py::arg("Transfer"))
+      .def("GetGeometryTransfer", &MediaReceiver::GetGeometryTransfer)
+      .def("SetTransferWindow", &MediaReceiver::SetTransferWindow, py::arg("MaxWindow"), py::arg("Adaptive") = true)
+      .def("GetTransferWindow", &MediaReceiver::GetTransferWindow)
+      .def("SetSendHighWaterMark", &MediaReceiver::SetSendHighWaterMark, py::arg("Bytes"))
+      .def("GetSendHighWaterMark", &MediaReceiver::GetSendHighWaterMark)
+      .def("SetPacing", &MediaReceiver::SetPacing, py::arg("BytesPerSecond"), py::arg("BurstBytes") = 0)
+      .def("SetBulkBufferLimit", &MediaReceiver::SetBulkBufferLimit, py::arg("Bytes"))
+      .def("GetBulkBufferLimit", &MediaReceiver::GetBulkBufferLimit)
+      .def("GetLaneLatency", &MediaReceiver::GetLaneLatency, py::arg("Priority"), py::return_value_policy::reference_internal)
+      .def("SetCoalescing", &MediaReceiver::SetCoalescing, py::arg("Enable"), py::arg("DeadlineSeconds") = 0.002)
+      .def("IsCoalescing", &MediaReceiver::IsCoalescing)
+      .def("FlushBatch", &MediaReceiver::FlushBatch)
+      .def("SetStripeChannels", &MediaReceiver::SetStripeChannels, py::arg("Count"))
+      .def("GetStripeChannels", &MediaReceiver::GetStripeChannels)
+      .def("GetOpenStripeChannels", &MediaReceiver::GetOpenStripeChannels)
+      .def("SendStriped", &MediaReceiver::SendStriped, py::arg("Buffer"))
+      .def("SetFragmentTimeout", &MediaReceiver::SetFragmentTimeout, py::arg("Seconds"))
+      .def("SetFragmentLimit", &MediaReceiver::SetFragmentLimit, py::arg("Bytes"))
+      .def("SetFragmentBudget", &MediaReceiver::SetFragmentBudget, py::arg("Bytes"))
+      .def("SetTelemetryChannel", &MediaReceiver::SetTelemetryChannel, py::arg("Enable"), py::arg("LifetimeMilliseconds") = 0)
+      .def("SetTelemetryTypes", &MediaReceiver::SetTelemetryTypes, py::arg("Types"))
+      .def("GetTelemetryTypes", &MediaReceiver::GetTelemetryTypes)
+      .def("HasTelemetryChannel", &MediaReceiver::HasTelemetryChannel)
+      .def("GetDroppedTelemetry", &MediaReceiver::GetDroppedTelemetry)
+      .def("SetExtendedFraming", &MediaReceiver::SetExtendedFraming, py::arg("Enable"))
+      .def("UsesExtendedFrames", &MediaReceiver::UsesExtendedFrames)
+      .def("GetMaxFramePayload", &MediaReceiver::GetMaxFramePayload)
       .def("SetDontWaitForAnswer", &MediaReceiver::SetDontWaitForAnswer, py::arg("DontWaitForAnswer"))
       .def_readwrite("IP", &MediaReceiver::IP)
       .def_readwrite("PortRange", &MediaReceiver::IP)
-      .def("LockUntilConnected", &MediaReceiver::LockUntilConnected, py::arg("additional_wait") = 0)
+      .def("LockUntilConnected", &MediaReceiver::LockUntilConnected, py::arg("additional_wait") = 0, py::arg("timeout") = -1.0)
+      .def("WaitForState", &MediaReceiver::WaitForState, py::arg("State"), py::arg("TimeOut") = -1.0)
+      .def("GetWaitMetric", &MediaReceiver::GetWaitMetric, py::return_value_policy::reference_internal)
     ;
 
     py::enum_<rtc::PeerConnection::GatheringState>(m, "GatheringState")
@@ -0,0 +1,138 @@
+#include "RequestTracker.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+Synavis::RequestTracker::RequestTracker(uint32_t inNextId)
+  : NextId(std::clamp(inNextId, FirstId, static_cast<uint32_t>(std::numeric_limits<int32_t>::max())))
+{
+}
+
+Synavis::RequestTracker::~RequestTracker()
+{
+  FailAll(std::make_exception_ptr(std::runtime_error("The connection was closed before the peer answered")));
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Stopping = true;
+  }
+  DeadlineCondition.notify_all();
+  if (Expiry.joinable())
+    Expiry.join();
+}
+
+uint32_t Synavis::RequestTracker::Open(clock::time_point Deadline, Completion Done)
+{
+  uint32_t id;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    // the plugin reads the pid as a 32 bit signed integer
+    do
+    {
+      id = NextId;
+      NextId = (NextId == static_cast<uint32_t>(std::numeric_limits<int32_t>::max())) ? FirstId : NextId + 1;
+    } while (Requests.contains(id));
+    Requests.emplace(id, Pending{ Deadline, std::move(Done) });
+    ++PendingCount;
+    if (!Expiry.joinable())
+      Expiry = std::thread(&RequestTracker::ExpireRequests, this);
+  }
+  DeadlineCondition.notify_all();
+  return id;
+}
+
+bool Synavis::RequestTracker::Complete(const JsonView& Message)
+{
+  const auto id = Message.Number<int64_t>("player_id");
+  if (!id.has_value() || id.value() < FirstId || id.value() > std::numeric_limits<int32_t>::max())
+    return false;
+  Completion done;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    auto it = Requests.find(static_cast<uint32_t>(id.value()));
+    if (it == Requests.end())
+      return false;
+    done = std::move(it->second.Done);
+    Requests.erase(it);
+    --PendingCount;
+  }
+  // the completion may send the next request, so it runs without the lock
+  if (Message.Type() == "error")
+  {
+    const auto reason = Message.String("message");
+    done(nullptr, std::make_exception_ptr(std::runtime_error("The peer answered with an error: "
+      + std::string(reason.value_or(Message.Text())))));
+  }
+  else
+  {
+    done(Message.Tree(), nullptr);
+  }
+  return true;
+}
+
+void Synavis::RequestTracker::Fail(uint32_t Id, std::exception_ptr Error)
+{
+  Completion done;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    auto it = Requests.find(Id);
+    if (it == Requests.end())
+      return;
+    done = std::move(it->second.Done);
+    Requests.erase(it);
+    --PendingCount;
+  }
+  done(nullptr, Error);
+}
+
+void Synavis::RequestTracker::FailAll(std::exception_ptr Error)
+{
+  std::vector<Completion> remaining;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    for (auto& [id, request] : Requests)
+      remaining.push_back(std::move(request.Done));
+    Requests.clear();
+    PendingCount = 0;
+  }
+  for (auto& done : remaining)
+    done(nullptr, Error);
+}
+
+void Synavis::RequestTracker::ExpireRequests()
+{
+  std::unique_lock<std::mutex> lock(Mutex);
+  while (!Stopping)
+  {
+    if (Requests.empty())
+    {
+      DeadlineCondition.wait(lock, [this]() { return Stopping || !Requests.empty(); });
+      continue;
+    }
+    // a copy, the request may be completed while the thread waits
+    const auto earliest = std::ranges::min_element(Requests, {}, [](const auto& Request) { return Request.second.Deadline; })->second.Deadline;
+    if (clock::now() < earliest)
+    {
+      // a new request with an earlier deadline wakes the thread as well
+      DeadlineCondition.wait_until(lock, earliest);
+      continue;
+    }
+    std::vector<Completion> expired;
+    const auto now = clock::now();
+    std::erase_if(Requests, [&expired, now](auto& Request)
+      {
+        if (Request.second.Deadline > now)
+          return false;
+        expired.push_back(std::move(Request.second.Done));
+        return true;
+      });
+    PendingCount -= expired.size();
+    lock.unlock();
+    const auto error = std::make_exception_ptr(std::runtime_error("The peer did not answer before the deadline"));
+    for (auto& done : expired)
+      done(nullptr, error);
+    lock.lock();
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef SYNAVIS_REQUESTTRACKER_HPP
+#define SYNAVIS_REQUESTTRACKER_HPP
+#include <json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "JsonView.hpp"
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // keeps the requests that wait for an answer of the peer. Every request gets an id that is
+  // sent as "pid" and that the Unreal plugin echoes as "player_id" in its answer, so that any
+  // number of requests can be in flight at once. A request is completed exactly once: with the
+  // answer, with an error if the peer answers with an error or nothing arrives before its
+  // deadline, or when the tracker is destroyed
+  class SYNAVIS_EXPORT RequestTracker
+  {
+  public:
+    using json = nlohmann::json;
+    using clock = std::chrono::steady_clock;
+    // receives the answer, or a null value and the error that ended the request
+    using Completion = std::function<void(json, std::exception_ptr)>;
+    // the ids of buffer transfers are 16 bit and lie below, so both can share the player_id
+    static constexpr uint32_t FirstId{ 1u << 16 };
+
+    // the ids run from FirstId up to the largest 32 bit signed integer and start over behind it.
+    // inNextId is the first id that Open hands out, e.g. to keep clear of the ids of a previous tracker
+    explicit RequestTracker(uint32_t inNextId = FirstId);
+    RequestTracker(const RequestTracker&) = delete;
+    RequestTracker& operator=(const RequestTracker&) = delete;
+    ~RequestTracker();
+
+    uint32_t Open(clock::time_point Deadline, Completion Done);
+    // completes the request that Message answers, returns false if it answers none
+    bool Complete(const JsonView& Message);
+    void Fail(uint32_t Id, std::exception_ptr Error);
+    // fails every open request, e.g. when the connection is closed
+    void FailAll(std::exception_ptr Error);
+    bool HasPending() const { return PendingCount > 0; }
+    std::size_t GetPendingCount() const { return PendingCount; }
+
+  private:
+    struct Pending
+    {
+      clock::time_point Deadline;
+      Completion Done;
+    };
+    // completes the requests whose deadline has passed, runs on its own thread
+    void ExpireRequests();
+    mutable std::mutex Mutex;
+    std::condition_variable DeadlineCondition;
+    std::unordered_map<uint32_t, Pending> Requests;
+    std::atomic<std::size_t> PendingCount{ 0 };
+    uint32_t NextId{ FirstId };
+    bool Stopping{ false };
+    std::thread Expiry;
+  };
+}
+#endif
@@ -0,0 +1,138 @@
+#include "SceneState.hpp"
+#include "DataConnector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+namespace
+{
+  using json = nlohmann::json;
+
+  // a query is answered with {"value":v} for scalars, {"x","y","z"} for vectors and
+  // {"p","y","r"} for rotators, while the track message pushes v, [x,y,z] and [p,y,r]
+  json ToTrackShape(const json& Answer)
+  {
+    if (!Answer.is_object())
+      return Answer;
+    if (Answer.size() == 1 && Answer.contains("value"))
+      return Answer["value"];
+    for (const auto& components : { std::array{ "x", "y", "z" }, std::array{ "p", "y", "r" } })
+    {
+      if (Answer.size() == 3 && std::ranges::all_of(components, [&Answer](const char* Key) { return Answer.contains(Key); }))
+        return json::array({ Answer[components[0]], Answer[components[1]], Answer[components[2]] });
+    }
+    return Answer;
+  }
+}
+
+Synavis::SceneState::SceneState(DataConnector& inConnector)
+  : Connector(inConnector)
+{
+}
+
+std::string Synavis::SceneState::Key(std::string_view Object, std::string_view Property)
+{
+  std::string key;
+  key.reserve(Object.size() + Property.size() + 1);
+  key.append(Object).append(".").append(Property);
+  return key;
+}
+
+void Synavis::SceneState::Track(const std::string& Object, const std::string& Property)
+{
+  Connector.SendJSON({ {"type","track"},{"object",Object},{"property",Property} });
+}
+
+void Synavis::SceneState::Untrack(const std::string& Object, const std::string& Property)
+{
+  Connector.SendJSON({ {"type","untrack"},{"object",Object},{"property",Property} });
+  std::lock_guard<std::mutex> lock(Mutex);
+  if (auto it = Entries.find(Key(Object, Property)); it != Entries.end())
+    Entries.erase(it);
+}
+
+void Synavis::SceneState::Store(std::string_view Name, std::string_view Raw, clock::time_point Received, std::optional<double> RemoteTime)
+{
+  auto it = Entries.find(Name);
+  if (it == Entries.end())
+    it = Entries.emplace(std::string(Name), Entry{}).first;
+  // the text keeps its capacity, so a property that is pushed every tick is not reallocated
+  it->second.Raw.assign(Raw);
+  ++it->second.Version;
+  it->second.Received = Received;
+  it->second.RemoteTime = RemoteTime;
+}
+
+void Synavis::SceneState::Update(const JsonView& Message)
+{
+  const auto data = Message.Object("data");
+  if (!data.has_value())
+    return;
+  const auto received = clock::now();
+  const auto remote_time = Message.Number<double>("time");
+  std::lock_guard<std::mutex> lock(Mutex);
+  data->ForEachMember([&](std::string_view Name, std::string_view Raw)
+    {
+      Store(Name, Raw, received, remote_time);
+    });
+}
+
+std::optional<Synavis::SceneState::Sample> Synavis::SceneState::Get(std::string_view Object, std::string_view Property) const
+{
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    const auto it = Entries.find(Key(Object, Property));
+    if (it == Entries.end())
+      return std::nullopt;
+    entry = it->second;
+  }
+  return Sample{ json::parse(entry.Raw, nullptr, false), entry.Version, entry.Received, entry.RemoteTime };
+}
+
+std::optional<Synavis::SceneState::json> Synavis::SceneState::GetFresh(std::string_view Object, std::string_view Property, double MaxAgeSeconds) const
+{
+  const auto oldest = clock::now() - std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(MaxAgeSeconds));
+  std::string raw;
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    const auto it = Entries.find(Key(Object, Property));
+    if (it == Entries.end() || it->second.Received < oldest)
+      return std::nullopt;
+    raw = it->second.Raw;
+  }
+  ++CacheHits;
+  return json::parse(raw, nullptr, false);
+}
+
+Synavis::SceneState::json Synavis::SceneState::Read(const std::string& Object, const std::string& Property, double MaxAgeSeconds, double TimeoutSeconds)
+{
+  if (auto cached = GetFresh(Object, Property, MaxAgeSeconds); cached.has_value())
+    return std::move(cached.value());
+  ++RemoteReads;
+  // the answer is {"type":"query","name":"Object.Property","data":value}
+  const auto answer = Connector.Request({ {"type","query"},{"object",Object},{"property",Property} }, TimeoutSeconds).get();
+  const auto data = answer.find("data");
+  // the plugin answers with an empty object if it cannot read the property
+  if (data == answer.end() || (data->is_object() && data->empty()))
+    throw std::runtime_error("The query for " + Key(Object, Property) + " was answered without data");
+  auto value = ToTrackShape(*data);
+  {
+    std::lock_guard<std::mutex> lock(Mutex);
+    Store(Key(Object, Property), value.dump(), clock::now(), std::nullopt);
+  }
+  return value;
+}
+
+void Synavis::SceneState::Clear()
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  Entries.clear();
+}
+
+std::size_t Synavis::SceneState::Size() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Entries.size();
+}
@@ -0,0 +1,104 @@
+#pragma once
+#ifndef SYNAVIS_SCENESTATE_HPP
+#define SYNAVIS_SCENESTATE_HPP
+#include <json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "JsonView.hpp"
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  class DataConnector;
+
+  // a local copy of the properties that the Unreal plugin pushes with every track message,
+  // {"type":"track","time":...,"data":{"Object.Property":value,...}}. Every property keeps the
+  // text of its last value, the number of updates it has seen and the time it arrived, so a
+  // control loop can read it without a round trip as long as it is fresh enough. Reads of
+  // stale or untracked properties fall back to a query of the peer and store its answer.
+  // Values always have the shape of the track message: numbers, booleans and strings as they
+  // are, vectors as [x,y,z] and rotators as [pitch,yaw,roll]
+  class SYNAVIS_EXPORT SceneState
+  {
+  public:
+    using json = nlohmann::json;
+    using clock = std::chrono::steady_clock;
+    struct Sample
+    {
+      json Value;
+      // counts the updates of this property
+      uint64_t Version{ 0 };
+      clock::time_point Received;
+      // the time of the track message as the peer reported it, none for query answers
+      std::optional<double> RemoteTime;
+      double Age() const { return std::chrono::duration<double>(clock::now() - Received).count(); }
+    };
+
+    explicit SceneState(DataConnector& inConnector);
+    SceneState(const SceneState&) = delete;
+    SceneState& operator=(const SceneState&) = delete;
+
+    // the connector only feeds track messages into an enabled state
+    void SetEnabled(bool Enable) { Enabled = Enable; }
+    bool IsEnabled() const { return Enabled; }
+    // asks the peer to push the property with every track message, or to stop doing so
+    void Track(const std::string& Object, const std::string& Property);
+    void Untrack(const std::string& Object, const std::string& Property);
+
+    // stores the values of a track message
+    void Update(const JsonView& Message);
+    // the last value regardless of its age
+    std::optional<Sample> Get(std::string_view Object, std::string_view Property) const;
+    // the last value if it arrived at most MaxAgeSeconds ago
+    std::optional<json> GetFresh(std::string_view Object, std::string_view Property, double MaxAgeSeconds) const;
+    /**
+     * \brief The value of the property, from the cache if it is at most MaxAgeSeconds old and
+     * from a query of the peer otherwise. The answer of the query is brought into the shape
+     * of the track message before it is stored. Throws if the peer does not answer in time
+     * or does not know the property.
+     * \param Object
+     * \param Property
+     * \param MaxAgeSeconds
+     * \param TimeoutSeconds for the query, 0 uses the time out of the connector
+     */
+    json Read(const std::string& Object, const std::string& Property, double MaxAgeSeconds, double TimeoutSeconds = 0.0);
+
+    void Clear();
+    std::size_t Size() const;
+    uint64_t GetCacheHits() const { return CacheHits; }
+    uint64_t GetRemoteReads() const { return RemoteReads; }
+
+  private:
+    struct Entry
+    {
+      // the value is parsed when it is read, most pushed values are never read
+      std::string Raw;
+      uint64_t Version{ 0 };
+      clock::time_point Received;
+      std::optional<double> RemoteTime;
+    };
+    struct StringHash
+    {
+      using is_transparent = void;
+      std::size_t operator()(std::string_view Text) const noexcept { return std::hash<std::string_view>{}(Text); }
+    };
+    // the plugin names the values "Object.Property"
+    static std::string Key(std::string_view Object, std::string_view Property);
+    void Store(std::string_view Name, std::string_view Raw, clock::time_point Received, std::optional<double> RemoteTime);
+
+    DataConnector& Connector;
+    std::atomic<bool> Enabled{ false };
+    mutable std::mutex Mutex;
+    std::unordered_map<std::string, Entry, StringHash, std::equal_to<>> Entries;
+    mutable std::atomic<uint64_t> CacheHits{ 0 };
+    std::atomic<uint64_t> RemoteReads{ 0 };
+  };
+}
+#endif
@@ -36,10 +36,11 @@ bool Synavis::Seeker::EstablishedConnection(bool Shallow)
   }
   else
   {
-    int PingPongSuccessful = -1;
-    std::chrono::system_clock::time_point precheck = std::chrono::system_clock::now();
+    // the task can outlive this call if the wait times out, so it must not refer to our stack
+    auto PingPongSuccessful = std::make_shared<std::promise<bool>>();
+    auto Result = PingPongSuccessful->get_future();
     std::cout << this->Prefix() << "Saving time point for ping" << std::endl;
-    CreateTask([this, &PingPongSuccessful]
+    CreateTask([this, PingPongSuccessful]
       {
         std::cout << this->Prefix() << "Sending ping" << std::endl;
         auto sent = BridgeConnection.Out->Send(json({ {"ping",int()} }).dump());
@@ -62,28 +63,18 @@ bool Synavis::Seeker::EstablishedConnection(bool Shallow)
         try
         {
           std::cout << this->Prefix() << "Received something that might be a pong" << std::endl;
-          if (json::parse(BridgeConnection.In->StringData)["ping"] == 1)
-          {
-            PingPongSuccessful = 1;
-          }
+          PingPongSuccessful->set_value(json::parse(BridgeConnection.In->StringData)["ping"] == 1);
         }
         catch (...)
         {
-          PingPongSuccessful = 0;
+          PingPongSuccessful->set_value(false);
         }
       });
 
-    while (PingPongSuccessful == -1)
-    {
-      std::chrono::system_clock::time_point sysnow = std::chrono::system_clock::now();
-      auto orig_diff = sysnow - precheck;
-      auto diff = std::chrono::duration_cast<std::chrono::seconds>(orig_diff);
-      if (diff < Timeout || TimeoutPolicy < EMessageTimeoutPolicy::Critical)
-        std::this_thread::yield();
-      else
-        break;
-    }
-    return PingPongSuccessful == 1;
+    std::optional<WaitMetric::clock::time_point> deadline;
+    if (TimeoutPolicy >= EMessageTimeoutPolicy::Critical)
+      deadline = WaitMetric::clock::now() + Timeout;
+    return Waits.Wait(Result, deadline) && Result.get();
   }
 }
 
@@ -10,8 +10,15 @@
 #include <fstream>
 #include <queue>
 #include <ostream>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <optional>
 #include <rtc/rtc.hpp>
 #include "Synavis/export.hpp"
+#include "Base64.hpp"
 
 #define MAX_RTP_SIZE 208 * 1024
 
@@ -94,48 +101,25 @@ namespace Synavis
     return Data.size() * sizeof(decltype(*Data.data()));
   }
 
-  // a function to encode a rtc::binary object into a base64 string
-  // adapted from https://stackoverflow.com/questions/180947/base64-decode-snippet-in-c
+  // a function to encode a buffer into a base64 string
+  // the transcoding is dispatched to the widest instruction set the cpu supports, see Base64.hpp
   template < typename T >
-  static std::string_view Encode64(const T& Data)
+  static std::string Encode64(const T& Data)
   {
     // check if the data is convertible to a pointer
     static_assert(is_pointer_convertible<T>::value, "Data must be convertible to a pointer");
-    std::size_t byte_size = Data.size() * sizeof(decltype(*Data.data()));
-    // convert data to string of bytes
-    std::string_view strdata(reinterpret_cast<const char*>(Data.data()), byte_size);
-    // base64 encoding table
-    constexpr char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    // compute the size of the encoded string
-    std::size_t encoded_length = 4 * ((byte_size + 2) / 3);
-    char* c = new char[encoded_length];
-    std::string_view c_result = { c, encoded_length };
-    std::size_t i;
-    for (i = 0; i < byte_size - 2; i += 3)
-    {
-      *c++ = table[(strdata[i] >> 2) & 0x3F];
-      *c++ = table[((strdata[i] & 0x3) << 4) | ((int)(strdata[i + 1] & 0xF0) >> 4)];
-      *c++ = table[((strdata[i + 1] & 0xF) << 2) | ((int)(strdata[i + 2] & 0xC0) >> 6)];
-      *c++ = table[strdata[i + 2] & 0x3F];
-    }
-    if (i < byte_size)
-    {
-      *c++ = table[(strdata[i] >> 2) & 0x3F];
-      if (i == (byte_size - 1))
-      {
-        *c++ = table[((strdata[i] & 0x3) << 4)];
-        *c++ = '=';
-      }
-      else
-      {
-        *c++ = table[((strdata[i] & 0x3) << 4) | ((int)(strdata[i + 1] & 0xF0) >> 4)];
-        *c++ = table[((strdata[i + 1] & 0xF) << 2)];
-      }
-      *c++ = '=';
-    }
-    // return the encoded string as a string_view because this way the data
-    // is not deleted when the scope ends in which this function is called
-    return  c_result;
+    return Base64Encode(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(Data.data()), ByteSize(Data)));
+  }
+
+  // the inverse of Encode64, trailing bytes that do not make up a full element are discarded
+  template < typename T >
+  static std::vector<T> Decode64(std::string_view Encoded)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Decoded type must be trivially copyable");
+    const auto bytes = Base64Decode(Encoded);
+    std::vector<T> result(bytes.size() / sizeof(T));
+    std::memcpy(result.data(), bytes.data(), result.size() * sizeof(T));
+    return result;
   }
 
   // a function to retrieve the encoded size of a buffer for base64 encoding
@@ -401,6 +385,11 @@ namespace Synavis
         Parent->SetState(V);
         return *this;
       }
+      // whether a message of this verbosity would be written at all
+      bool IsEnabled(ELogVerbosity V) const
+      {
+        return Parent->IsEnabled(V);
+      }
 
     };
     // singleton
@@ -477,6 +466,12 @@ namespace Synavis
       return Verbosity;
     }
 
+    // allows callers to skip assembling messages that would be discarded
+    bool IsEnabled(ELogVerbosity V) const
+    {
+      return V <= Verbosity;
+    }
+
     void SetVerbosity(std::string V)
     {
       // make V lowercase
@@ -584,6 +579,66 @@ namespace Synavis
     bool Running = true;
   };
 
+  // accumulates the time that threads spent blocked in the waits of one component
+  class SYNAVIS_EXPORT WaitMetric
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    // blocks until Done holds or the deadline has passed, returns whether Done holds
+    // Lock must hold the mutex that guards the state that Done inspects
+    template < typename Predicate >
+    bool Wait(std::condition_variable& Condition, std::unique_lock<std::mutex>& Lock,
+      std::optional<clock::time_point> Deadline, Predicate&& Done)
+    {
+      if (Done())
+        return true;
+      const auto start = clock::now();
+      bool result;
+      if (Deadline.has_value())
+        result = Condition.wait_until(Lock, Deadline.value(), Done);
+      else
+      {
+        Condition.wait(Lock, Done);
+        result = true;
+      }
+      Add(clock::now() - start);
+      return result;
+    }
+
+    // blocks until the future is ready or the deadline has passed
+    template < typename T >
+    bool Wait(std::future<T>& Future, std::optional<clock::time_point> Deadline)
+    {
+      const auto start = clock::now();
+      bool result = true;
+      if (Deadline.has_value())
+        result = Future.wait_until(Deadline.value()) == std::future_status::ready;
+      else
+        Future.wait();
+      Add(clock::now() - start);
+      return result;
+    }
+
+    void Add(clock::duration Waited)
+    {
+      const auto nanoseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Waited).count());
+      Nanoseconds += nanoseconds;
+      Count++;
+      auto longest = Longest.load();
+      while (nanoseconds > longest && !Longest.compare_exchange_weak(longest, nanoseconds));
+    }
+    // total time spent waiting in seconds
+    double GetSeconds() const { return static_cast<double>(Nanoseconds.load()) * 1e-9; }
+    double GetLongestSeconds() const { return static_cast<double>(Longest.load()) * 1e-9; }
+    uint64_t GetCount() const { return Count.load(); }
+    void Reset() { Nanoseconds = 0; Count = 0; Longest = 0; }
+  private:
+    std::atomic<uint64_t> Nanoseconds{ 0 };
+    std::atomic<uint64_t> Count{ 0 };
+    std::atomic<uint64_t> Longest{ 0 };
+  };
+
   class SYNAVIS_EXPORT Bridge
   {
   public:
@@ -631,7 +686,9 @@ namespace Synavis
     virtual void RemoteMessage(json Message) = 0;
     virtual void OnSignallingData(rtc::binary Message) = 0;
     void Stop();
+    const WaitMetric& GetWaitMetric() const { return Waits; }
   protected:
+    WaitMetric Waits;
     EMessageTimeoutPolicy TimeoutPolicy;
     std::chrono::system_clock::duration Timeout;
     json Config{
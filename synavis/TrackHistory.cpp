@@ -0,0 +1,194 @@
+#include "TrackHistory.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+  constexpr double NaN = std::numeric_limits<double>::quiet_NaN();
+
+  bool ParseNumber(std::string_view Text, double& Value)
+  {
+    while (!Text.empty() && (Text.front() == ' ' || Text.front() == '\t' || Text.front() == '\r' || Text.front() == '\n'))
+      Text.remove_prefix(1);
+    while (!Text.empty() && (Text.back() == ' ' || Text.back() == '\t' || Text.back() == '\r' || Text.back() == '\n'))
+      Text.remove_suffix(1);
+    const auto [end, error] = std::from_chars(Text.data(), Text.data() + Text.size(), Value);
+    return error == std::errc() && end == Text.data() + Text.size();
+  }
+
+  // the numeric content of a value: a number, a boolean or a flat array of numbers.
+  // Returns false for anything else, such as strings, which have no place in a column
+  bool ParseValues(std::string_view Raw, std::vector<double>& Values)
+  {
+    Values.clear();
+    if (Raw == "true" || Raw == "false")
+    {
+      Values.push_back(Raw == "true" ? 1.0 : 0.0);
+      return true;
+    }
+    if (Raw.size() < 2 || Raw.front() != '[' || Raw.back() != ']')
+    {
+      double value;
+      if (!ParseNumber(Raw, value))
+        return false;
+      Values.push_back(value);
+      return true;
+    }
+    auto items = Raw.substr(1, Raw.size() - 2);
+    while (!items.empty())
+    {
+      const auto comma = items.find(',');
+      double value;
+      if (!ParseNumber(items.substr(0, comma), value))
+        return false;
+      Values.push_back(value);
+      if (comma == std::string_view::npos)
+        break;
+      items.remove_prefix(comma + 1);
+    }
+    return !Values.empty();
+  }
+}
+
+Synavis::TrackHistory::TrackHistory(std::size_t inCapacity)
+  : Capacity(inCapacity)
+{
+  if (Capacity == 0)
+    throw std::runtime_error("A track history needs room for at least one row");
+  ReceiveTimes = Column{ 1, std::vector<double>(2 * Capacity, NaN) };
+  PeerTimes = Column{ 1, std::vector<double>(2 * Capacity, NaN) };
+}
+
+Synavis::TrackHistory::Column& Synavis::TrackHistory::AddColumn(std::string_view Name, std::size_t Width)
+{
+  // the rows before the property appeared have no value
+  Columns.push_back(std::make_unique<Column>(Column{ Width, std::vector<double>(2 * Capacity * Width, NaN) }));
+  ColumnIndex.emplace(std::string(Name), Columns.size() - 1);
+  return *Columns.back();
+}
+
+void Synavis::TrackHistory::WriteRow(Column& Target, std::size_t Slot, const double* Values)
+{
+  std::copy_n(Values, Target.Width, Target.Values.data() + Slot * Target.Width);
+  std::copy_n(Values, Target.Width, Target.Values.data() + (Slot + Capacity) * Target.Width);
+}
+
+void Synavis::TrackHistory::Update(const JsonView& Message)
+{
+  const auto data = Message.Object("data");
+  if (!data.has_value())
+    return;
+  const double received = std::chrono::duration<double>(clock::now() - Created).count();
+  const double peer_time = Message.Number<double>("time").value_or(NaN);
+  thread_local std::vector<double> values;
+  thread_local std::vector<uint8_t> written;
+  std::lock_guard<std::mutex> lock(Mutex);
+  const std::size_t slot = Written % Capacity;
+  written.assign(Columns.size(), 0);
+  data->ForEachMember([&](std::string_view Name, std::string_view Raw)
+    {
+      if (!ParseValues(Raw, values))
+        return;
+      std::size_t index;
+      if (const auto it = ColumnIndex.find(Name); it != ColumnIndex.end())
+      {
+        index = it->second;
+        // a column keeps the width of the first value, others cannot be stored in it
+        if (Columns[index]->Width != values.size())
+          return;
+      }
+      else
+      {
+        AddColumn(Name, values.size());
+        index = Columns.size() - 1;
+        written.push_back(0);
+      }
+      WriteRow(*Columns[index], slot, values.data());
+      written[index] = 1;
+    });
+  for (std::size_t index = 0; index < Columns.size(); ++index)
+  {
+    if (written[index])
+      continue;
+    values.assign(Columns[index]->Width, NaN);
+    WriteRow(*Columns[index], slot, values.data());
+  }
+  WriteRow(ReceiveTimes, slot, &received);
+  WriteRow(PeerTimes, slot, &peer_time);
+  ++Written;
+}
+
+void Synavis::TrackHistory::Clear()
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  Written = 0;
+  for (auto& column : Columns)
+    std::ranges::fill(column->Values, NaN);
+  std::ranges::fill(ReceiveTimes.Values, NaN);
+  std::ranges::fill(PeerTimes.Values, NaN);
+}
+
+std::size_t Synavis::TrackHistory::Size() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return static_cast<std::size_t>(std::min<uint64_t>(Written, Capacity));
+}
+
+uint64_t Synavis::TrackHistory::GetWritten() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return Written;
+}
+
+std::vector<std::string> Synavis::TrackHistory::GetProperties() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  std::vector<std::string> names(Columns.size());
+  for (const auto& [name, index] : ColumnIndex)
+    names[index] = name;
+  return names;
+}
+
+Synavis::TrackHistory::ColumnView Synavis::TrackHistory::MakeView(const Column& Source) const
+{
+  // once the ring is full the oldest row is the one that is written next
+  const std::size_t rows = static_cast<std::size_t>(std::min<uint64_t>(Written, Capacity));
+  const std::size_t first = (Written > Capacity) ? static_cast<std::size_t>(Written % Capacity) : 0;
+  return ColumnView{ Source.Values.data() + first * Source.Width, rows, Source.Width, Written };
+}
+
+std::optional<Synavis::TrackHistory::ColumnView> Synavis::TrackHistory::View(std::string_view Property) const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto it = ColumnIndex.find(Property);
+  if (it == ColumnIndex.end())
+    return std::nullopt;
+  return MakeView(*Columns[it->second]);
+}
+
+Synavis::TrackHistory::ColumnView Synavis::TrackHistory::Times() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return MakeView(ReceiveTimes);
+}
+
+Synavis::TrackHistory::ColumnView Synavis::TrackHistory::RemoteTimes() const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  return MakeView(PeerTimes);
+}
+
+bool Synavis::TrackHistory::Copy(std::string_view Property, std::vector<double>& Values, std::size_t& Width) const
+{
+  std::lock_guard<std::mutex> lock(Mutex);
+  const auto it = ColumnIndex.find(Property);
+  if (it == ColumnIndex.end())
+    return false;
+  const auto view = MakeView(*Columns[it->second]);
+  Values.assign(view.Data, view.Data + view.Rows * view.Width);
+  Width = view.Width;
+  return true;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#ifndef SYNAVIS_TRACKHISTORY_HPP
+#define SYNAVIS_TRACKHISTORY_HPP
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "JsonView.hpp"
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // the last Capacity track messages in columns of doubles, one column per tracked property
+  // plus the receive time and the time that the peer reported. Every message is one row;
+  // numbers and booleans take one value per row, vectors and rotators one value per
+  // component, properties that a message lacks are NaN in its row. Every row is written
+  // twice, at its slot and Capacity rows behind it, so the rows held are always contiguous
+  // from the oldest to the newest and can be handed out without copying
+  class SYNAVIS_EXPORT TrackHistory
+  {
+  public:
+    using clock = std::chrono::steady_clock;
+    // Rows values of Width doubles each, oldest first, with a row stride of Width. The rows
+    // are in order only while GetWritten() still returns the Written of the view
+    struct ColumnView
+    {
+      const double* Data{ nullptr };
+      std::size_t Rows{ 0 };
+      std::size_t Width{ 0 };
+      uint64_t Written{ 0 };
+    };
+
+    explicit TrackHistory(std::size_t inCapacity);
+    TrackHistory(const TrackHistory&) = delete;
+    TrackHistory& operator=(const TrackHistory&) = delete;
+
+    // appends the values of a track message as one row
+    void Update(const JsonView& Message);
+    // drops the rows, the columns stay in place so that views into them remain valid
+    void Clear();
+
+    std::size_t GetCapacity() const { return Capacity; }
+    // number of rows held, at most the capacity
+    std::size_t Size() const;
+    // number of rows written since the last clear
+    uint64_t GetWritten() const;
+    std::vector<std::string> GetProperties() const;
+
+    // the views point into the ring, which stays valid as long as the history. The next update
+    // overwrites the oldest row of every view with the newest one, so a reader compares the
+    // Written of the view with GetWritten() after reading and falls back to Copy if it moved
+    std::optional<ColumnView> View(std::string_view Property) const;
+    // seconds since the history was created, at which the rows were received
+    ColumnView Times() const;
+    // the "time" member of the track messages, NaN where there was none
+    ColumnView RemoteTimes() const;
+    // copies the rows of the property, oldest first, returns false if it is not tracked
+    bool Copy(std::string_view Property, std::vector<double>& Values, std::size_t& Width) const;
+
+  private:
+    struct Column
+    {
+      std::size_t Width;
+      std::vector<double> Values;
+    };
+    struct StringHash
+    {
+      using is_transparent = void;
+      std::size_t operator()(std::string_view Text) const noexcept { return std::hash<std::string_view>{}(Text); }
+    };
+    Column& AddColumn(std::string_view Name, std::size_t Width);
+    // writes Width values of the row Slot and its mirror
+    void WriteRow(Column& Target, std::size_t Slot, const double* Values);
+    ColumnView MakeView(const Column& Source) const;
+
+    const std::size_t Capacity;
+    const clock::time_point Created{ clock::now() };
+    mutable std::mutex Mutex;
+    uint64_t Written{ 0 };
+    Column ReceiveTimes;
+    Column PeerTimes;
+    // unique_ptr keeps the columns in place when more are added
+    std::vector<std::unique_ptr<Column>> Columns;
+    std::unordered_map<std::string, std::size_t, StringHash, std::equal_to<>> ColumnIndex;
+  };
+}
+#endif
@@ -0,0 +1,211 @@
+#include "Utf16.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SYNAVIS_UTF16_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define SYNAVIS_UTF16_X86 0
+#endif
+
+// the vector paths are compiled for their instruction set only, the library itself
+// stays at the baseline and picks the path at runtime
+#if defined(__GNUC__) || defined(__clang__)
+#define SYNAVIS_TARGET(x) __attribute__((target(x)))
+#else
+#define SYNAVIS_TARGET(x)
+#endif
+
+namespace
+{
+  using Synavis::EUtf16Backend;
+
+  inline uint32_t Unit(const uint8_t* Source, std::size_t Index)
+  {
+    return static_cast<uint32_t>(Source[2 * Index]) | (static_cast<uint32_t>(Source[2 * Index + 1]) << 8);
+  }
+
+  // converts the units from Index up to End, a surrogate pair that starts before End is
+  // completed even if its second half lies behind it. Returns the index of the next unit
+  std::size_t ConvertScalar(const uint8_t* Source, std::size_t Index, std::size_t End, std::size_t Units, char*& Out)
+  {
+    while (Index < End)
+    {
+      uint32_t code = Unit(Source, Index++);
+      if (code < 0x80)
+      {
+        *Out++ = static_cast<char>(code);
+        continue;
+      }
+      if (code < 0x800)
+      {
+        *Out++ = static_cast<char>(0xC0 | (code >> 6));
+        *Out++ = static_cast<char>(0x80 | (code & 0x3F));
+        continue;
+      }
+      if (code >= 0xD800 && code <= 0xDFFF)
+      {
+        const uint32_t low = Index < Units ? Unit(Source, Index) : 0;
+        if (code <= 0xDBFF && low >= 0xDC00 && low <= 0xDFFF)
+        {
+          ++Index;
+          code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+          *Out++ = static_cast<char>(0xF0 | (code >> 18));
+          *Out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+          *Out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+          *Out++ = static_cast<char>(0x80 | (code & 0x3F));
+          continue;
+        }
+        // a surrogate without its partner does not encode a character
+        code = 0xFFFD;
+      }
+      *Out++ = static_cast<char>(0xE0 | (code >> 12));
+      *Out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      *Out++ = static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return Index;
+  }
+
+#if SYNAVIS_UTF16_X86
+  // 16 units per step, a step with a unit above 0x7F is handed to the scalar conversion
+  SYNAVIS_TARGET("sse2") std::size_t ConvertSSE2(const uint8_t* Source, std::size_t Units, char* Destination)
+  {
+    const __m128i non_ascii = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    char* out = Destination;
+    std::size_t i = 0;
+    while (i + 16 <= Units)
+    {
+      const __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + 2 * i));
+      const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Source + 2 * i + 16));
+      const __m128i high_bits = _mm_and_si128(_mm_or_si128(first, second), non_ascii);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, zero)) == 0xFFFF)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(first, second));
+        out += 16;
+        i += 16;
+      }
+      else
+      {
+        i = ConvertScalar(Source, i, i + 16, Units, out);
+      }
+    }
+    ConvertScalar(Source, i, Units, Units, out);
+    return static_cast<std::size_t>(out - Destination);
+  }
+
+  // 32 units per step
+  SYNAVIS_TARGET("avx2") std::size_t ConvertAVX2(const uint8_t* Source, std::size_t Units, char* Destination)
+  {
+    const __m256i non_ascii = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    char* out = Destination;
+    std::size_t i = 0;
+    while (i + 32 <= Units)
+    {
+      const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + 2 * i));
+      const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(Source + 2 * i + 32));
+      if (_mm256_testz_si256(_mm256_or_si256(first, second), non_ascii))
+      {
+        // the pack works per 128 bit lane, the permutation puts the quarters back in order
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+        out += 32;
+        i += 32;
+      }
+      else
+      {
+        i = ConvertScalar(Source, i, i + 32, Units, out);
+      }
+    }
+    ConvertScalar(Source, i, Units, Units, out);
+    return static_cast<std::size_t>(out - Destination);
+  }
+#endif
+
+  EUtf16Backend DetectBackend()
+  {
+#if SYNAVIS_UTF16_X86
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    const bool sse2 = (info[3] & (1 << 26)) != 0;
+    // avx2 also requires the os to save the ymm registers
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6)
+    {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    const bool sse2 = __builtin_cpu_supports("sse2");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+      return EUtf16Backend::AVX2;
+    if (sse2)
+      return EUtf16Backend::SSE2;
+#endif
+    return EUtf16Backend::Scalar;
+  }
+
+  EUtf16Backend Resolve(EUtf16Backend Requested)
+  {
+    const EUtf16Backend available = Synavis::Utf16Backend();
+    if (Requested == EUtf16Backend::Automatic || Requested > available)
+      return available;
+    return Requested;
+  }
+}
+
+Synavis::EUtf16Backend Synavis::Utf16Backend()
+{
+  static const EUtf16Backend detected = DetectBackend();
+  return detected;
+}
+
+std::string Synavis::Utf16BackendName(EUtf16Backend Backend)
+{
+  switch (Resolve(Backend))
+  {
+  case EUtf16Backend::AVX2:
+    return "avx2";
+  case EUtf16Backend::SSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
+
+std::size_t Synavis::Utf16ToUtf8(const uint8_t* Source, std::size_t Units, char* Destination, EUtf16Backend Backend)
+{
+  switch (Resolve(Backend))
+  {
+#if SYNAVIS_UTF16_X86
+  case EUtf16Backend::AVX2:
+    return ConvertAVX2(Source, Units, Destination);
+  case EUtf16Backend::SSE2:
+    return ConvertSSE2(Source, Units, Destination);
+#endif
+  default:
+  {
+    char* out = Destination;
+    ConvertScalar(Source, 0, Units, Units, out);
+    return static_cast<std::size_t>(out - Destination);
+  }
+  }
+}
+
+void Synavis::Utf16ToUtf8(std::span<const uint8_t> Source, std::string& Destination, EUtf16Backend Backend)
+{
+  const std::size_t units = Source.size() / 2;
+  Destination.resize_and_overwrite(Utf8LengthBound(units), [&](char* Buffer, std::size_t)
+    {
+      return Utf16ToUtf8(Source.data(), units, Buffer, Backend);
+    });
+}
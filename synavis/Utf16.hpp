@@ -0,0 +1,43 @@
+#pragma once
+#ifndef SYNAVIS_UTF16_HPP
+#define SYNAVIS_UTF16_HPP
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <string>
+#include "Synavis/export.hpp"
+
+namespace Synavis
+{
+  // the instruction set that is used for utf-16 transcoding
+  // Automatic resolves to the widest set that the cpu supports
+  enum class SYNAVIS_EXPORT EUtf16Backend
+  {
+    Scalar = 0u,
+    SSE2,
+    AVX2,
+    Automatic
+  };
+
+  // the backend that the runtime dispatch has selected for this cpu
+  EUtf16Backend SYNAVIS_EXPORT Utf16Backend();
+  std::string SYNAVIS_EXPORT Utf16BackendName(EUtf16Backend Backend = EUtf16Backend::Automatic);
+
+  // upper bound for the number of bytes that Units utf-16 code units turn into
+  constexpr std::size_t Utf8LengthBound(std::size_t Units)
+  {
+    return 3 * Units;
+  }
+
+  // converts Units little endian utf-16 code units, as Unreal sends them, into Destination,
+  // which must hold at least Utf8LengthBound(Units) bytes. Surrogate pairs become one four
+  // byte sequence, unpaired surrogates become U+FFFD. Returns the number of bytes written.
+  // Runs of ascii are converted 16 or 32 units at a time.
+  std::size_t SYNAVIS_EXPORT Utf16ToUtf8(const uint8_t* Source, std::size_t Units, char* Destination,
+    EUtf16Backend Backend = EUtf16Backend::Automatic);
+  // replaces the content of Destination with the converted text, a trailing odd byte is ignored.
+  // The capacity of Destination is reused, so a buffer that is kept around does not allocate
+  void SYNAVIS_EXPORT Utf16ToUtf8(std::span<const uint8_t> Source, std::string& Destination,
+    EUtf16Backend Backend = EUtf16Backend::Automatic);
+}
+#endif